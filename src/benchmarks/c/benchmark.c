@@ -5,6 +5,8 @@
  * copy-on-write, aggregating metrics internally for minimal IPC overhead. */
 #include "cts.h"
 #include "util.h"
+#include "lawn2w.h"
+#include "impl/adaptive.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -164,6 +166,24 @@ static size_t payload_delete(const cts_vtable *vt, cts_store *s, const scenario_
 
 static void teardown_delete(scenario_t *sc) { free(sc->delete_perm); }
 
+/* `delete`, but each batch of B goes to the adapter's stop_batch in one call
+ * (the "client disconnected, cancel all its timers" shape; n stop()s when it
+ * has none). Same shuffled order, so every batch hits scattered nodes. */
+static size_t payload_delete_batch(const cts_vtable *vt, cts_store *s, const scenario_t *sc, void *run_state, double *out) {
+    (void)run_state;
+    size_t timed = sc->p.n < MAX_OPS ? sc->p.n : MAX_OPS, c = 0;
+    for (size_t k = 0; k < timed; ) {
+        size_t bs = (timed - k) < BATCH ? (timed - k) : BATCH;
+        uint64_t t0 = cts_now_ns();
+        if (vt->stop_batch) vt->stop_batch(s, sc->delete_perm + k, bs);
+        else for (size_t j = 0; j < bs; j++) vt->stop(s, sc->delete_perm[k + j]);
+        out[c++] = (double)(cts_now_ns() - t0) / (double)bs;
+        k += bs;
+    }
+    for (size_t k = timed; k < sc->p.n; k++) vt->stop(s, sc->delete_perm[k]);
+    return c;
+}
+
 /* ---- 3. Empty Tick Operation ---- */
 static void setup_empty_tick(scenario_t *sc) {
     for (size_t i = 0; i < sc->p.n; i++) sc->ttls[i] += TICKS;
@@ -481,6 +501,79 @@ static void teardown_lifecycle(scenario_t *sc) {
     free(sc->lc_rolls_replenish);
 }
 
+/* ---- 8. Cancel Operation ----
+ * Cancel-dominated churn, the shape of connection/request timers that are
+ * almost always cancelled and re-armed rather than fired: every timed step
+ * cancels one live timer and re-arms it with the same TTL, visiting the full
+ * population in shuffled order (setup_delete's permutation) so each cancel
+ * lands on a cold node in an arbitrary bucket. Nothing ever expires; ns are
+ * per cancel+re-arm pair. */
+static size_t payload_cancel(const cts_vtable *vt, cts_store *s, const scenario_t *sc, void *run_state, double *out) {
+    (void)run_state;
+    size_t timed = sc->p.n < MAX_OPS ? sc->p.n : MAX_OPS, c = 0;
+    for (size_t k = 0; k < timed; ) {
+        size_t bs = (timed - k) < BATCH ? (timed - k) : BATCH;
+        uint64_t t0 = cts_now_ns();
+        for (size_t j = 0; j < bs; j++) {
+            uint64_t id = sc->delete_perm[k + j];
+            vt->stop(s, id);
+            vt->start(s, id, sc->ttls[id]);
+        }
+        out[c++] = (double)(cts_now_ns() - t0) / (double)bs;
+        k += bs;
+    }
+    return c;
+}
+
+/* ---- 9. Extend Operation ----
+ * Extend-dominated churn, the keep-alive/idle-timeout shape: the clock moves
+ * one tick per batch and every timed step pushes one live timer's deadline
+ * out to now + its TTL (through the adapter's touch, else stop + start),
+ * visiting the population in setup_delete's shuffled order. The batch's tick
+ * is timed too, since a lazy store pays for postponements there. ns are per
+ * extend. */
+static size_t payload_extend(const cts_vtable *vt, cts_store *s, const scenario_t *sc, void *run_state, double *out) {
+    (void)run_state;
+    size_t timed = sc->p.n < MAX_OPS ? sc->p.n : MAX_OPS, c = 0;
+    for (size_t k = 0; k < timed; ) {
+        size_t bs = (timed - k) < BATCH ? (timed - k) : BATCH;
+        uint64_t t0 = cts_now_ns();
+        vt->tick(s);
+        for (size_t j = 0; j < bs; j++) {
+            uint64_t id = sc->delete_perm[k + j];
+            if (!vt->touch || !vt->touch(s, id)) {
+                vt->stop(s, id);
+                vt->start(s, id, sc->ttls[id]);
+            }
+        }
+        out[c++] = (double)(cts_now_ns() - t0) / (double)bs;
+        k += bs;
+    }
+    return c;
+}
+
+/* ---- 10. Batched Insert Operation ----
+ * The ingest shape: timers arrive a batch at a time (one network read, many
+ * requests). Same timers and timed range as `insert`, but each batch of B
+ * goes to the adapter's start_batch in one call (n start()s when it has
+ * none). ns are per timer. */
+static size_t payload_insert_batch(const cts_vtable *vt, cts_store *s, const scenario_t *sc, void *run_state, double *out) {
+    (void)run_state;
+    size_t timed = sc->p.n < MAX_OPS ? sc->p.n : MAX_OPS;
+    size_t pre = sc->p.n - timed, c = 0;
+    uint64_t ids[BATCH];
+    for (size_t i = pre; i < sc->p.n; ) {
+        size_t bs = (sc->p.n - i) < BATCH ? (sc->p.n - i) : BATCH;
+        for (size_t k = 0; k < bs; k++) ids[k] = i + k;
+        uint64_t t0 = cts_now_ns();
+        if (vt->start_batch) vt->start_batch(s, ids, sc->ttls + i, bs);
+        else for (size_t k = 0; k < bs; k++) vt->start(s, ids[k], sc->ttls[i + k]);
+        out[c++] = (double)(cts_now_ns() - t0) / (double)bs;
+        i += bs;
+    }
+    return c;
+}
+
 /* ---- Configuration Array ---- */
 static const op_t OPS[] = {
     {"insert",       MAX_OPS / BATCH + 2, NULL,             pre_insert,    payload_insert,       NULL,             NULL},
@@ -490,6 +583,10 @@ static const op_t OPS[] = {
     {"memory",       1,                   NULL,             NULL,          payload_memory,       NULL,             NULL},
     {"tick_scan",    TICK_SCAN_SAMPLES,   setup_tick_scan,  pre_start_all, payload_tick_scan,    NULL,             teardown_tick_scan},
     {"lifecycle",    OP_PER_N,            setup_lifecycle,  pre_lifecycle, payload_lifecycle,    post_lifecycle,   teardown_lifecycle},
+    {"cancel",       MAX_OPS / BATCH + 2, setup_delete,     pre_start_all, payload_cancel,       NULL,             teardown_delete},
+    {"extend",       MAX_OPS / BATCH + 2, setup_delete,     pre_start_all, payload_extend,       NULL,             teardown_delete},
+    {"insert_batch", MAX_OPS / BATCH + 2, NULL,             pre_insert,    payload_insert_batch, NULL,             NULL},
+    {"delete_batch", MAX_OPS / BATCH + 2, setup_delete,     pre_start_all, payload_delete_batch, NULL,             teardown_delete},
 };
 
 /* ---- Utility & Memory Tracking ---- */
@@ -519,10 +616,18 @@ static double bytes_per_timer_estimate(const char *algo) {
     if (!strcmp(algo, "lawn"))       return 113.0;
     if (!strcmp(algo, "lawn2"))      return 48.0;
     if (!strcmp(algo, "lawn2clamp")) return 48.0;
+    if (!strcmp(algo, "lawn2idx"))   return 48.0;
+    if (!strcmp(algo, "lawn2hybrid")) return 48.0;
+    if (!strcmp(algo, "lawn2direct")) return 48.0;
+    if (!strcmp(algo, "lawn2seg"))   return 48.0;
+    if (!strcmp(algo, "lawn2lazy"))  return 56.0;   /* node + its ttl */
+    if (!strcmp(algo, "lawn2compact")) return 16.0;
+    if (!strcmp(algo, "lawn2ring"))  return 24.0;   /* 8-byte node + 16-byte entry */
     if (!strcmp(algo, "wahern"))     return 88.0;
     if (!strcmp(algo, "naive"))      return 38.0;
     if (!strcmp(algo, "heap"))       return 25.0;
     if (!strcmp(algo, "wheelexact")) return 32.0;
+    if (!strcmp(algo, "adaptive"))   return 97.0;   /* wahern node + deadline/where by id */
     return 150.0;
 }
 
@@ -911,6 +1016,294 @@ static void run_distribution(const char *dir) {
     printf("wrote %s\n", path);
 }
 
+/* ---- Watermark Driver ---- */
+/* Watermark-driven expiry over k event-time inputs: lawn2w's min-heap against
+ * the obvious alternative, a running minimum rescanned over all inputs when
+ * the input holding it advances. Both replay the same update sequence onto a
+ * lawn2 store of BASE_N preloaded timers. Patterns:
+ *  - even: in rounds, every input advances once, in random order, to a
+ *    jittered point of the round's span; one in 16 stalls for the round
+ *  - straggler: the same, but input 0 lags rounds behind and creeps
+ *    forward between every two other updates, so the minimum sits on the
+ *    busiest input
+ * WM_UPDATES updates either way, spread so the watermark crosses WM_SPAN. */
+#define WM_UPDATES 2000000
+#define WM_SPAN    65536
+
+typedef struct { uint32_t input; uint64_t wm; } wm_update_t;
+
+static void wm_gen(wm_update_t *u, uint32_t k, int straggler) {
+    uint32_t *order = malloc(k * sizeof *order);
+    uint64_t rng = SEED, rounds = WM_UPDATES / ((uint64_t)k * (straggler ? 2 : 1));
+    uint64_t step = rounds < WM_SPAN ? WM_SPAN / rounds : 1;
+    size_t j = 0;
+    for (uint64_t r = 1; j < WM_UPDATES; r++) {
+        for (uint32_t i = 0; i < k; i++) order[i] = i;
+        for (uint32_t x = 0; x < k && j < WM_UPDATES; x++) {
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint32_t y = x + (uint32_t)((rng >> 33) % (k - x)), in = order[y];
+            order[y] = order[x];
+            order[x] = in;
+            if (straggler) {
+                if (in == 0) continue;
+                /* input 0 creeps through the span of 4 rounds back, below
+                 * even the inputs that stalled since */
+                u[j++] = (wm_update_t){ 0, (r > 4 ? (r - 4) * step : 0) + x * step / k };
+                if (j == WM_UPDATES) break;
+            }
+            if ((rng >> 20) % 16 == 0) continue;                 /* stalls this round */
+            u[j++] = (wm_update_t){ in, r * step + (rng >> 40) % step };
+        }
+    }
+    free(order);
+}
+
+/* Indexed: a watermark moving a few ticks per update must not pay an O(t)
+ * blade scan for each of them. */
+static lawn2 *wm_store(timer_store *st) {
+    lawn2_config cfg = { .flags = LAWN2_INDEXED };
+    lawn2 *l = lawn2_new_config(&cfg);
+    uint64_t rng = SEED;
+    for (uint64_t i = 0; i < BASE_N; i++) {
+        rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+        lawn2_add(l, timer_for(st, i), 1 + (rng >> 33) % WM_SPAN);
+    }
+    return l;
+}
+
+static double wm_run_heap(const wm_update_t *u, uint32_t k, uint64_t *fired) {
+    timer_store *st = init_store();
+    lawn2 *l = wm_store(st);
+    lawn2w *w = lawn2w_new(l, k);
+    uint64_t t0 = cts_now_ns();
+    for (size_t j = 0; j < WM_UPDATES; j++) *fired += lawn2w_update(w, u[j].input, u[j].wm, NULL);
+    double ns = (double)(cts_now_ns() - t0) / WM_UPDATES;
+    lawn2w_free(w);
+    lawn2_free(l);
+    destroy_store(st);
+    return ns;
+}
+
+static double wm_run_rescan(const wm_update_t *u, uint32_t k, uint64_t *fired) {
+    timer_store *st = init_store();
+    lawn2 *l = wm_store(st);
+    uint64_t *wm = calloc(k, sizeof *wm), min = 0;
+    uint32_t argmin = 0;
+    uint64_t t0 = cts_now_ns();
+    for (size_t j = 0; j < WM_UPDATES; j++) {
+        if (u[j].wm <= wm[u[j].input]) continue;
+        wm[u[j].input] = u[j].wm;
+        if (u[j].input != argmin) continue;
+        min = UINT64_MAX;
+        for (uint32_t i = 0; i < k; i++) if (wm[i] < min) { min = wm[i]; argmin = i; }
+        if (min > lawn2_now(l)) *fired += lawn2_advance(l, min, NULL);
+    }
+    double ns = (double)(cts_now_ns() - t0) / WM_UPDATES;
+    free(wm);
+    lawn2_free(l);
+    destroy_store(st);
+    return ns;
+}
+
+static void run_watermark(const char *dir) {
+    static const uint32_t KS[] = {10, 100, 1000, 10000};
+    static const char *PATTERNS[] = {"even", "straggler"};
+    char path[512];
+    snprintf(path, sizeof path, "%s/watermark.csv", dir);
+    FILE *f = fopen(path, "w");
+    fprintf(f, "pattern,inputs,updates,fired,final_watermark,lawn2w_ns_per_update,rescan_ns_per_update\n");
+    printf("watermark-driven expiry (lawn2w heap vs rescan-on-min, n=%d timers):\n", BASE_N);
+    wm_update_t *u = malloc(WM_UPDATES * sizeof *u);
+    for (int pi = 0; pi < 2; pi++) {
+        for (size_t ki = 0; ki < GET_SIZE(KS); ki++) {
+            uint32_t k = KS[ki];
+            wm_gen(u, k, pi);
+            uint64_t fired_heap = 0, fired_scan = 0;
+            double scan_ns = wm_run_rescan(u, k, &fired_scan);
+            double heap_ns = wm_run_heap(u, k, &fired_heap);
+            if (fired_heap != fired_scan) printf("  MISMATCH %s k=%u: %llu vs %llu fired\n", PATTERNS[pi], k,
+                                                 (unsigned long long)fired_heap, (unsigned long long)fired_scan);
+            uint64_t final = UINT64_MAX, *cur = calloc(k, sizeof *cur);  /* combined watermark reached */
+            for (size_t j = 0; j < WM_UPDATES; j++) if (u[j].wm > cur[u[j].input]) cur[u[j].input] = u[j].wm;
+            for (uint32_t i = 0; i < k; i++) if (cur[i] < final) final = cur[i];
+            free(cur);
+            printf("  %-9s k=%-6u lawn2w %.2f ns/update | rescan %.2f ns/update | fired %llu\n",
+                   PATTERNS[pi], k, heap_ns, scan_ns, (unsigned long long)fired_heap);
+            fprintf(f, "%s,%u,%d,%llu,%llu,%.2f,%.2f\n", PATTERNS[pi], k, WM_UPDATES,
+                    (unsigned long long)fired_heap, (unsigned long long)final, heap_ns, scan_ns);
+            fflush(f);
+        }
+    }
+    free(u);
+    fclose(f);
+    printf("  wrote %s\n", path);
+}
+
+/* ---- Slack Driver ---- */
+/* Timers that tolerate lateness, pushed with lawn2_add_slack against exact
+ * lawn2_add. Steady churn in scan mode: SL_PER_TICK pushes a tick with TTLs
+ * drawn from SL_TTLS distinct values above SL_TTL_MIN, each allowed to be
+ * late by a fixed fraction of its TTL. Reports the blades held, the Poll
+ * (tick) and Push costs over the measured ticks once the store is full,
+ * and the mean lateness the slack took. */
+#define SL_PER_TICK 100
+#define SL_TTL_MIN  1000
+#define SL_TTLS     10000
+#define SL_WARMUP   (SL_TTL_MIN + SL_TTLS)
+#define SL_MEASURE  10000
+#define SL_IDS      ((SL_WARMUP * 11 / 10 + 2) * SL_PER_TICK)   /* outlives the latest timer */
+
+static void run_slack(const char *dir) {
+    static const uint64_t PERMILLE[] = {0, 1, 10, 50, 100};
+    char path[512];
+    snprintf(path, sizeof path, "%s/slack.csv", dir);
+    FILE *f = fopen(path, "w");
+    fprintf(f, "slack_permille,distinct_ttls,blades,add_ns,tick_ns,mean_late,max_late\n");
+    printf("slack windows (lawn2_add_slack, %d pushes/tick over %d distinct TTLs):\n", SL_PER_TICK, SL_TTLS);
+    for (size_t pi = 0; pi < GET_SIZE(PERMILLE); pi++) {
+        timer_store *st = init_store();
+        reserve_store(st, SL_IDS);
+        lawn2 *l = lawn2_new();
+        uint64_t rng = SEED, id = 0, add_ns = 0, tick_ns = 0;
+        for (uint64_t t = 0; t < SL_WARMUP + SL_MEASURE; t++) {
+            int timed = t >= SL_WARMUP;
+            uint64_t t0 = cts_now_ns();
+            for (int k = 0; k < SL_PER_TICK; k++, id = (id + 1) % SL_IDS) {
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                uint64_t ttl = SL_TTL_MIN + (rng >> 33) % SL_TTLS;
+                lawn2_add_slack(l, timer_for(st, id), ttl, ttl * PERMILLE[pi] / 1000);
+            }
+            uint64_t t1 = cts_now_ns();
+            lawn2_tick(l, NULL);
+            if (timed) {
+                add_ns += t1 - t0;
+                tick_ns += cts_now_ns() - t1;
+            }
+        }
+        lawn2_stats s;
+        lawn2_get_stats(l, &s);
+        double adds = (double)SL_MEASURE * SL_PER_TICK;
+        double mean_late = s.slack_adds ? (double)s.slack_late_sum / (double)s.slack_adds : 0;
+        printf("  slack %5.1f%%: %6llu blades | add %.2f ns | tick %.0f ns | late mean %.1f max %llu ticks\n",
+               PERMILLE[pi] / 10.0, (unsigned long long)s.blades, add_ns / adds,
+               (double)tick_ns / SL_MEASURE, mean_late, (unsigned long long)s.slack_late_max);
+        fprintf(f, "%llu,%d,%llu,%.2f,%.0f,%.2f,%llu\n", (unsigned long long)PERMILLE[pi], SL_TTLS,
+                (unsigned long long)s.blades, add_ns / adds, (double)tick_ns / SL_MEASURE, mean_late,
+                (unsigned long long)s.slack_late_max);
+        fflush(f);
+        lawn2_free(l);
+        destroy_store(st);
+    }
+    fclose(f);
+    printf("  wrote %s\n", path);
+}
+
+/* ---- Long-Tail Driver ---- */
+/* The hybrid mode's case: most timers share a few popular TTLs, and the
+ * rest carry near-unique ones (client-supplied deadlines), each its own
+ * one-timer blade. Steady churn of LT_PER_TICK pushes a tick, LT_TAIL_PCT%
+ * of them from the tail, against the scan store, hybrid (cfg.cold_max = 8)
+ * and LAWN2_INDEXED. Reports Push and Poll (tick) cost once full. */
+#define LT_PER_TICK 100
+#define LT_POPULAR  8
+#define LT_TAIL     100000
+#define LT_WARMUP   (2000 + LT_TAIL)
+#define LT_MEASURE  20000
+#define LT_IDS      ((LT_WARMUP + 2) * LT_PER_TICK)
+
+static void run_longtail(const char *dir) {
+    static const int TAIL_PCT[] = {1, 10, 50};
+    static const char *MODES[] = {"scan", "hybrid", "indexed"};
+    char path[512];
+    snprintf(path, sizeof path, "%s/longtail.csv", dir);
+    FILE *f = fopen(path, "w");
+    fprintf(f, "tail_pct,mode,blades,cold_blades,add_ns,tick_ns\n");
+    printf("long-tail TTLs (%d pushes/tick, %d popular TTLs + a tail of unique ones):\n", LT_PER_TICK, LT_POPULAR);
+    for (size_t pi = 0; pi < GET_SIZE(TAIL_PCT); pi++) {
+        for (int mode = 0; mode < 3; mode++) {
+            timer_store *st = init_store();
+            reserve_store(st, LT_IDS);
+            lawn2_config cfg = { .flags = mode == 2 ? LAWN2_INDEXED : 0, .cold_max = mode == 1 ? 8 : 0 };
+            lawn2 *l = lawn2_new_config(&cfg);
+            uint64_t rng = SEED, id = 0, add_ns = 0, tick_ns = 0;
+            for (uint64_t t = 0; t < LT_WARMUP + LT_MEASURE; t++) {
+                uint64_t t0 = cts_now_ns();
+                for (int k = 0; k < LT_PER_TICK; k++, id = (id + 1) % LT_IDS) {
+                    rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                    uint64_t r = rng >> 33;
+                    uint64_t ttl = (int)(r % 100) < TAIL_PCT[pi] ? 1000 + (r >> 7) % LT_TAIL
+                                                                 : 1000 * (1 + (r >> 7) % LT_POPULAR);
+                    lawn2_add(l, timer_for(st, id), ttl);
+                }
+                uint64_t t1 = cts_now_ns();
+                lawn2_tick(l, NULL);
+                if (t >= LT_WARMUP) {
+                    add_ns += t1 - t0;
+                    tick_ns += cts_now_ns() - t1;
+                }
+            }
+            lawn2_stats s;
+            lawn2_get_stats(l, &s);
+            double adds = (double)LT_MEASURE * LT_PER_TICK;
+            printf("  tail %2d%% %-7s: %6llu blades (%6llu cold) | add %.2f ns | tick %.0f ns\n",
+                   TAIL_PCT[pi], MODES[mode], (unsigned long long)s.blades,
+                   (unsigned long long)s.cold_blades, add_ns / adds, (double)tick_ns / LT_MEASURE);
+            fprintf(f, "%d,%s,%llu,%llu,%.2f,%.0f\n", TAIL_PCT[pi], MODES[mode],
+                    (unsigned long long)s.blades, (unsigned long long)s.cold_blades,
+                    add_ns / adds, (double)tick_ns / LT_MEASURE);
+            fflush(f);
+            lawn2_free(l);
+            destroy_store(st);
+        }
+    }
+    fclose(f);
+    printf("  wrote %s\n", path);
+}
+
+/* ---- Adaptive Driver ---- */
+/* The "adaptive" store's case: a workload that moves across the lawn-vs-wheel
+ * inflection point. AD_N timers churn round-robin (stop + start, then one
+ * tick per step), AD_STEPS steps per phase, with the phase's ttls drawn
+ * from AD_T[phase] distinct values over a 10000-tick span. Reports ns per
+ * step for lawn2, wahern and adaptive, and adaptive's engine at phase end. */
+#define AD_N     50000
+#define AD_STEPS 1000000
+
+static void run_adaptive(const char *dir) {
+    static const uint64_t AD_T[] = {10, 5000, 10, 5000};
+    static const cts_vtable *const ALGOS[] = {&cts_lawn2_vtable, &cts_wahern_vtable, &cts_adaptive_vtable};
+    char path[512];
+    snprintf(path, sizeof path, "%s/adaptive.csv", dir);
+    FILE *f = fopen(path, "w");
+    fprintf(f, "phase,t,algo,step_ns,engine\n");
+    printf("adaptive engine selection (%d timers, phases of %d steps):\n", AD_N, AD_STEPS);
+    for (size_t ai = 0; ai < GET_SIZE(ALGOS); ai++) {
+        const cts_vtable *vt = ALGOS[ai];
+        cts_store *s = vt->create();
+        uint64_t rng = SEED;
+        for (uint64_t id = 0; id < AD_N; id++) vt->start(s, id, 1 + id % 10000);
+        for (size_t ph = 0; ph < GET_SIZE(AD_T); ph++) {
+            uint64_t t0 = cts_now_ns();
+            for (uint64_t k = 0; k < AD_STEPS; k++) {
+                uint64_t id = k % AD_N;
+                rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+                vt->stop(s, id);
+                vt->start(s, id, 1 + (rng >> 33) % AD_T[ph] * (10000 / AD_T[ph]));
+                vt->tick(s);
+            }
+            double ns = (double)(cts_now_ns() - t0) / AD_STEPS;
+            const char *eng = vt == &cts_adaptive_vtable ? cts_adaptive_engine(s) : vt->name;
+            printf("  phase %zu t=%-5llu %-8s: %7.1f ns/step (on %s)\n", ph,
+                   (unsigned long long)AD_T[ph], vt->name, ns, eng);
+            fprintf(f, "%zu,%llu,%s,%.1f,%s\n", ph, (unsigned long long)AD_T[ph], vt->name, ns, eng);
+            fflush(f);
+        }
+        vt->destroy(s);
+    }
+    fclose(f);
+    printf("  wrote %s\n", path);
+}
+
 /* ---- Entry Point & Single Driver ---- */
 static int wl_from_name(const char *s) {
     if (!strcmp(s, "uniform")) return WL_UNIFORM;
@@ -987,6 +1380,10 @@ int main(int argc, char **argv) {
         if (!strcmp(argv[1], "sweeps")) { run_sweeps(dir, false); }
         else if (!strcmp(argv[1], "dist")) { run_distribution(dir); }
         else if (!strcmp(argv[1], "inflection")) { run_inflection(dir); }
+        else if (!strcmp(argv[1], "watermark")) { run_watermark(dir); }
+        else if (!strcmp(argv[1], "slack")) { run_slack(dir); }
+        else if (!strcmp(argv[1], "longtail")) { run_longtail(dir); }
+        else if (!strcmp(argv[1], "adaptive")) { run_adaptive(dir); }
         else if (!strcmp(argv[1], "huge")) { run_sweeps(dir, true); }
         else if (!strcmp(argv[1], "single")) { return run_single(argc, argv); }
         else if (!strcmp(argv[1], "sweep-op")) {
@@ -11,8 +11,13 @@
  * so it cannot run in independent concurrent shards (a harness limitation, not
  * an algorithm one) and is excluded here.
  *
- *   ./concurrent <impl> <threads> <shards> <ms> [window] [seed]
+ *   ./concurrent <impl> <threads> <shards> <ms> [window] [seed] [reset|touch]
  * prints one CSV row: impl,threads,shards,ops,ops_per_sec,mean_ns,p50_ns,p99_ns,max_ns
+ *
+ * The churn op is `reset` (stop + start of the same id with a fresh random
+ * TTL; counted as 2 ops) by default, or `touch` (the adapter's keep-alive
+ * refresh: same id, same TTL, deadline pushed out; 1 op) for impls whose
+ * vtable provides it.
  */
 #define _GNU_SOURCE
 #include <pthread.h>
@@ -52,6 +57,7 @@ typedef struct {
     int window;
     uint64_t base_id;
     volatile int *stop;
+    int touch;
     unsigned seed;
     uint64_t ops;
     double *lat; int nlat, latcap;
@@ -70,6 +76,17 @@ static void *worker(void *p) {
         pthread_mutex_unlock(&a->shards[sh].lock);
     }
     uint64_t counter = 0;
+    while (!*a->stop && a->touch) {                /* churn: refresh one timer in place */
+        uint64_t id = a->base_id + (counter++ % (uint64_t)a->window);
+        int sh = route(id, a->nshards);
+        uint64_t t0 = now_ns();
+        pthread_mutex_lock(&a->shards[sh].lock);
+        a->vt->touch(a->shards[sh].store, id);
+        pthread_mutex_unlock(&a->shards[sh].lock);
+        a->ops += 1;
+        if (a->nlat < a->latcap && (a->ops & 127) == 0)
+            a->lat[a->nlat++] = (double)(now_ns() - t0);
+    }
     while (!*a->stop) {                            /* churn: reset one timer (stop+start same id) */
         uint64_t id = a->base_id + (counter++ % (uint64_t)a->window);
         uint64_t ttl = 1 + (rand_r(&s) % 1000);
@@ -93,15 +110,20 @@ static int cmp_d(const void *x, const void *y) {
 
 int main(int argc, char **argv) {
     if (argc < 5) {
-        fprintf(stderr, "usage: %s <impl> <threads> <shards> <ms> [window] [seed]\n", argv[0]);
+        fprintf(stderr, "usage: %s <impl> <threads> <shards> <ms> [window] [seed] [reset|touch]\n", argv[0]);
         return 2;
     }
     const char *impl = argv[1];
     int threads = atoi(argv[2]), shards = atoi(argv[3]), ms = atoi(argv[4]);
     int window = argc > 5 ? atoi(argv[5]) : 2000;
     unsigned seed = argc > 6 ? (unsigned)atoi(argv[6]) : 1234u;
+    int touch = argc > 7 && !strcmp(argv[7], "touch");
     const cts_vtable *vt = find_impl(impl);
     if (!vt) { fprintf(stderr, "unknown impl %s\n", impl); return 2; }
+    if (touch && !vt->touch) {
+        fprintf(stderr, "%s has no touch op\n", impl);
+        return 2;
+    }
     if (!strcmp(impl, "lawn") && shards != 1) {
         fprintf(stderr, "lawn uses a global clock; only shards=1 is valid\n");
         return 2;
@@ -117,7 +139,7 @@ int main(int argc, char **argv) {
     worker_arg *args = calloc((size_t)threads, sizeof *args);
     for (int i = 0; i < threads; i++) {
         args[i] = (worker_arg){ .vt = vt, .shards = sh, .nshards = shards,
-            .window = window, .base_id = (uint64_t)i * (uint64_t)window, .stop = &stop,
+            .window = window, .base_id = (uint64_t)i * (uint64_t)window, .stop = &stop, .touch = touch,
             .seed = seed + (unsigned)i, .latcap = 20000 };
         args[i].lat = malloc(sizeof(double) * (size_t)args[i].latcap);
     }
@@ -20,6 +20,16 @@ typedef struct {
      * not tick-by-tick) so a preload can be inserted at staggered arrival
      * times. NULL if the store can't jump its clock cheaply. */
     void       (*advance)(cts_store *, uint64_t target);
+    /* Optional: push a live timer's deadline out by its own TTL (keep-alive
+     * refresh); 1 refreshed, 0 absent. NULL if the store has no cheaper way
+     * than stop + start. */
+    int        (*touch)(cts_store *, uint64_t id);
+    /* Optional: start n timers (ids[i] with ttls[i]) in one call, same result
+     * as n start()s in order. NULL if the store has no bulk path. */
+    void       (*start_batch)(cts_store *, const uint64_t *ids, const uint64_t *ttls, size_t n);
+    /* Optional: stop n timers in one call, same result as n stop()s. NULL
+     * if the store has no bulk path. */
+    void       (*stop_batch)(cts_store *, const uint64_t *ids, size_t n);
 } cts_vtable;
 
 /* Injected logical clock shared with lawn.c's current_time_ms(). */
@@ -32,10 +42,18 @@ extern const int cts_nalgos;
 /* Adapters. */
 extern const cts_vtable cts_lawn_vtable;
 extern const cts_vtable cts_lawn2_vtable;
+extern const cts_vtable cts_lawn2_indexed_vtable;
+extern const cts_vtable cts_lawn2_hybrid_vtable;
+extern const cts_vtable cts_lawn2_direct_vtable;
+extern const cts_vtable cts_lawn2_segment_vtable;
+extern const cts_vtable cts_lawn2_lazy_vtable;
+extern const cts_vtable cts_lawn2_compact_vtable;
+extern const cts_vtable cts_lawn2_ring_vtable;
 extern const cts_vtable cts_lawn2_clamped_vtable;
 extern const cts_vtable cts_wahern_vtable;
 extern const cts_vtable cts_naive_vtable;
 extern const cts_vtable cts_heap_vtable;
 extern const cts_vtable cts_wheel_exact_vtable;
+extern const cts_vtable cts_adaptive_vtable;
 
 #endif /* CTS_H */
@@ -0,0 +1,215 @@
+/* cts adapter "adaptive": a self-tuning store that keeps its timers in either
+ * lawn2 or the wahern hierarchical wheel and migrates between them when the
+ * workload crosses the lawn-vs-wheel inflection point.
+ *
+ * Both engines are driven through their own cts_vtables. Every ADAPT_WINDOW
+ * events (start/stop/tick) the store prices the window just seen under both
+ * engines with a cost model fitted from results/inflection.csv (./benchmark
+ * inflection), tracked online from:
+ *   - N, the live timer count;
+ *   - t, the distinct TTLs in use, estimated by linear counting over a
+ *     bitmap of the TTLs started in the last two sketch generations;
+ *   - the tick/op mix of the window.
+ * A window in which the other engine would have been cheaper adds the
+ * difference to a credit (a cheaper window drains it, never below zero);
+ * once the credit covers the cost of moving every live timer, migration
+ * begins. That keeps a workload sitting near the crossover from flapping.
+ *
+ * Migration is amortized: new starts go straight to the target engine, and
+ * every event also moves up to ADAPT_STEP timers from a cursor over the id
+ * space (stop in the old engine, start in the new one with the remaining
+ * time). Until the cursor finishes both engines are ticked; then the old one
+ * is freed. where[] routes stop() to whichever engine holds the id. */
+#include "cts.h"
+#include "adaptive.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define ADAPT_WINDOW   1024     /* events per cost-model decision */
+#define ADAPT_STEP     4        /* timers moved per event while migrating */
+#define ADAPT_SCAN     64       /* ids looked at per event while migrating */
+#define SKETCH_LOG     13
+#define SKETCH_BITS    (1 << SKETCH_LOG)
+#define SKETCH_WORDS   (SKETCH_BITS / 64)
+#define SKETCH_WINDOWS 8        /* windows per sketch generation */
+
+enum { ENG_LAWN2, ENG_WHEEL };
+
+/* Cost model, in ns. The inflection sweep's lifecycle sample is 0.51 ops
+ * (0.5 start + 0.01 stop) plus one tick. Least squares over its t <= 1000
+ * rows gives lawn2_life = 7.71 + 0.10213 t, flat in N; the slope is the
+ * blade scan, so it is charged per tick and the intercept per op. wahern's
+ * lifecycle cost is flat in t but grows with N (per-N medians below, taken
+ * at log10 N = 3..7 and interpolated in between); all of it is charged per
+ * op, its empty ticks being O(1). */
+#define LIFE_OPS     0.51
+#define LAWN2_OP_NS  (7.71 / LIFE_OPS)
+#define LAWN2_SCAN_NS 0.10213
+static const double WHEEL_LIFE_NS[] = { 12.71, 12.67, 13.30, 24.60, 53.68 };
+
+struct cts_store {
+    const cts_vtable *vt[2];
+    cts_store *eng[2];          /* eng[!cur] is non-NULL only while migrating */
+    int        cur;             /* engine new starts go to */
+    uint64_t   now;
+    uint64_t  *deadline;        /* by id */
+    uint8_t   *where;           /* by id: 1 + engine holding it, 0 none */
+    size_t     cap, hi;         /* hi: one past the largest id seen */
+    size_t     cursor;
+    uint64_t   ops, ticks, windows;
+    double     credit;
+    uint64_t   sketch[2][SKETCH_WORDS];
+    int        gen;
+    uint64_t   migrations;
+};
+
+static double wheel_op_ns(uint64_t n) {
+    double x = log10((double)(n ? n : 1)) - 3.0;
+    int last = (int)(sizeof WHEEL_LIFE_NS / sizeof WHEEL_LIFE_NS[0]) - 1;
+    if (x <= 0) return WHEEL_LIFE_NS[0] / LIFE_OPS;
+    if (x >= last) return WHEEL_LIFE_NS[last] / LIFE_OPS;
+    int i = (int)x;
+    double f = x - i;
+    return (WHEEL_LIFE_NS[i] * (1 - f) + WHEEL_LIFE_NS[i + 1] * f) / LIFE_OPS;
+}
+
+static double ttl_estimate(const cts_store *s) {
+    int set = 0;
+    for (int w = 0; w < SKETCH_WORDS; w++)
+        set += __builtin_popcountll(s->sketch[0][w] | s->sketch[1][w]);
+    if (set == SKETCH_BITS) set = SKETCH_BITS - 1;
+    return SKETCH_BITS * log((double)SKETCH_BITS / (SKETCH_BITS - set));
+}
+
+static cts_store *ad_create(void) {
+    struct cts_store *s = calloc(1, sizeof *s);
+    s->vt[ENG_LAWN2] = &cts_lawn2_vtable;
+    s->vt[ENG_WHEEL] = &cts_wahern_vtable;
+    s->cur = ENG_LAWN2;
+    s->eng[ENG_LAWN2] = s->vt[ENG_LAWN2]->create();
+    return s;
+}
+
+static void ad_destroy(cts_store *s) {
+    for (int e = 0; e < 2; e++)
+        if (s->eng[e]) s->vt[e]->destroy(s->eng[e]);
+    free(s->deadline);
+    free(s->where);
+    free(s);
+}
+
+static void ensure_cap(cts_store *s, uint64_t id) {
+    if (id >= s->hi) s->hi = id + 1;
+    if (id < s->cap) return;
+    size_t nc = s->cap ? s->cap : 1024;
+    while (nc <= id) nc *= 2;
+    s->deadline = realloc(s->deadline, nc * sizeof *s->deadline);
+    s->where = realloc(s->where, nc * sizeof *s->where);
+    for (size_t i = s->cap; i < nc; i++) s->where[i] = 0;
+    s->cap = nc;
+}
+
+/* Move the next ADAPT_STEP timers still held by the old engine; ids that
+ * are dead or already moved cost a byte compare each, up to ADAPT_SCAN. */
+static void migrate_step(cts_store *s) {
+    int old = !s->cur, moved = 0;
+    for (int k = 0; k < ADAPT_SCAN && moved < ADAPT_STEP && s->cursor < s->hi; k++, s->cursor++) {
+        uint64_t id = s->cursor;
+        if (s->where[id] != 1 + old) continue;
+        s->where[id] = 0;
+        if (s->vt[old]->stop(s->eng[old], id)) {
+            s->vt[s->cur]->start(s->eng[s->cur], id, s->deadline[id] - s->now);
+            s->where[id] = 1 + s->cur;
+            moved++;
+        }
+    }
+    if (s->cursor >= s->hi) {
+        s->vt[old]->destroy(s->eng[old]);
+        s->eng[old] = NULL;
+        s->ops = s->ticks = 0;      /* the next window starts clean */
+    }
+}
+
+static uint64_t ad_size(cts_store *s) {
+    uint64_t n = 0;
+    for (int e = 0; e < 2; e++)
+        if (s->eng[e]) n += s->vt[e]->size(s->eng[e]);
+    return n;
+}
+
+/* Price the window under both engines and bank the difference. */
+static void decide(cts_store *s) {
+    uint64_t n = ad_size(s);
+    double t = ttl_estimate(s);
+    if (t > (double)n) t = (double)n;
+    if (t < 1) t = 1;
+    double cost[2];
+    cost[ENG_LAWN2] = s->ops * LAWN2_OP_NS + s->ticks * LAWN2_SCAN_NS * t;
+    cost[ENG_WHEEL] = s->ops * wheel_op_ns(n);
+    s->credit += cost[s->cur] - cost[!s->cur];
+    if (s->credit < 0) s->credit = 0;
+    s->ops = s->ticks = 0;
+    if (++s->windows % SKETCH_WINDOWS == 0) {
+        s->gen ^= 1;
+        for (int w = 0; w < SKETCH_WORDS; w++) s->sketch[s->gen][w] = 0;
+    }
+    if (s->credit <= n * (LAWN2_OP_NS + wheel_op_ns(n))) return;
+    s->cur = !s->cur;
+    s->eng[s->cur] = s->vt[s->cur]->create();
+    s->vt[s->cur]->advance(s->eng[s->cur], s->now);
+    s->cursor = 0;
+    s->credit = 0;
+    s->migrations++;
+}
+
+static void account(cts_store *s) {
+    if (s->eng[!s->cur]) migrate_step(s);
+    else if (s->ops + s->ticks >= ADAPT_WINDOW) decide(s);
+}
+
+static void ad_start(cts_store *s, uint64_t id, uint64_t ttl) {
+    ensure_cap(s, id);
+    int e = s->where[id] - 1;
+    if (e >= 0 && e != s->cur && s->eng[e]) s->vt[e]->stop(s->eng[e], id);
+    s->vt[s->cur]->start(s->eng[s->cur], id, ttl);
+    s->deadline[id] = s->now + ttl;
+    s->where[id] = 1 + s->cur;
+    uint64_t h = (ttl * 0x9e3779b97f4a7c15ULL) >> (64 - SKETCH_LOG);
+    s->sketch[s->gen][h / 64] |= 1ULL << (h % 64);
+    s->ops++;
+    account(s);
+}
+
+static int ad_stop(cts_store *s, uint64_t id) {
+    if (id >= s->cap || !s->where[id]) return 0;
+    int e = s->where[id] - 1;
+    s->where[id] = 0;
+    int r = s->vt[e]->stop(s->eng[e], id);
+    s->ops++;
+    account(s);
+    return r;
+}
+
+static uint64_t ad_tick(cts_store *s) {
+    uint64_t fired = 0;
+    s->now++;
+    for (int e = 0; e < 2; e++)
+        if (s->eng[e]) fired += s->vt[e]->tick(s->eng[e]);
+    s->ticks++;
+    account(s);
+    return fired;
+}
+
+static void ad_advance(cts_store *s, uint64_t target) {
+    s->now = target;
+    for (int e = 0; e < 2; e++)
+        if (s->eng[e]) s->vt[e]->advance(s->eng[e], target);
+}
+
+const char *cts_adaptive_engine(const cts_store *s) { return s->vt[s->cur]->name; }
+uint64_t cts_adaptive_migrations(const cts_store *s) { return s->migrations; }
+
+const cts_vtable cts_adaptive_vtable = {
+    "adaptive", ad_create, ad_destroy,
+    ad_start, ad_stop, ad_tick, ad_size, ad_advance, NULL, NULL, NULL,
+};
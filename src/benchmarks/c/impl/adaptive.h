@@ -0,0 +1,12 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include "cts.h"
+
+/* Name of the engine "adaptive" currently starts timers in ("lawn2" or
+ * "wahern"), and how many migrations it has begun. Exposed so test.c can
+ * check that the cost model actually switches. */
+const char *cts_adaptive_engine(const cts_store *s);
+uint64_t cts_adaptive_migrations(const cts_store *s);
+
+#endif /* ADAPTIVE_H */
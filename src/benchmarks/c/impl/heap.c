@@ -110,5 +110,5 @@ static void heap_advance(cts_store *s, uint64_t target) { s->now = target; }
 
 const cts_vtable cts_heap_vtable = {
     "heap", heap_create, heap_destroy,
-    heap_start, heap_stop, heap_tick, heap_size, heap_advance,
+    heap_start, heap_stop, heap_tick, heap_size, heap_advance, NULL, NULL, NULL,
 };
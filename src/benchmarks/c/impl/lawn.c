@@ -60,5 +60,5 @@ static void lawn_advance(cts_store *s, uint64_t target) { s->now = target; }
 
 const cts_vtable cts_lawn_vtable = {
     "lawn", lawn_create, lawn_destroy,
-    lawn_start, lawn_stop, lawn_tick, lawn_size, lawn_advance,
+    lawn_start, lawn_stop, lawn_tick, lawn_size, lawn_advance, NULL, NULL, NULL,
 };
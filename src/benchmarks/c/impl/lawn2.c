@@ -1,5 +1,10 @@
 /* cts adapter for lawn2. Nodes live in a slab pool indexed by id so their
- * addresses stay stable (never realloc a live block); no per-insert malloc. */
+ * addresses stay stable (never realloc a live block); no per-insert malloc.
+ * Also registers "lawn2idx": the same adapter over a LAWN2_INDEXED store,
+ * "lawn2hybrid": over a hybrid (cfg.cold_max) store, "lawn2direct": over
+ * one whose TTLs below 4096 index their blade directly, "lawn2seg": ticks
+ * through lawn2_advance_segments instead, and "lawn2lazy": touch goes
+ * through lawn2_extend (lazy postponement) instead of lawn2_touch. */
 #include "cts.h"
 #include "lawn2.h"
 #include <stdlib.h>
@@ -16,6 +21,32 @@ static cts_store *l2_create(void) {
     return s;
 }
 
+static cts_store *l2i_create(void) {
+    struct cts_store *s = calloc(1, sizeof *s);
+    lawn2_config cfg = { .flags = LAWN2_INDEXED };
+    s->l = lawn2_new_config(&cfg);
+    s->st = init_store();
+    return s;
+}
+
+/* Blades under 8 timers wait in the overflow heap. */
+static cts_store *l2h_create(void) {
+    struct cts_store *s = calloc(1, sizeof *s);
+    lawn2_config cfg = { .cold_max = 8 };
+    s->l = lawn2_new_config(&cfg);
+    s->st = init_store();
+    return s;
+}
+
+/* Every baseline TTL (span 1024) is below direct_max: no hashing at all. */
+static cts_store *l2d_create(void) {
+    struct cts_store *s = calloc(1, sizeof *s);
+    lawn2_config cfg = { .direct_max = 4096 };
+    s->l = lawn2_new_config(&cfg);
+    s->st = init_store();
+    return s;
+}
+
 static void l2_destroy(cts_store *s) {
     lawn2_free(s->l);
     destroy_store(s->st);
@@ -26,6 +57,16 @@ static void l2_start(cts_store *s, uint64_t id, uint64_t ttl) {
     lawn2_add(s->l, timer_for(s->st, id), ttl);
 }
 
+/* Resolve ids to nodes a stack slab at a time, then one lawn2_add_batch each. */
+static void l2_start_batch(cts_store *s, const uint64_t *ids, const uint64_t *ttls, size_t n) {
+    lawn2_timer *nodes[256];
+    for (size_t i = 0; i < n; i += 256) {
+        size_t m = n - i < 256 ? n - i : 256;
+        for (size_t k = 0; k < m; k++) nodes[k] = timer_for(s->st, ids[i + k]);
+        lawn2_add_batch(s->l, nodes, ttls + i, m);
+    }
+}
+
 static int l2_stop(cts_store *s, uint64_t id) {
     lawn2_timer *n = timer_for(s->st, id);
     if (!n->in_store) return 0;
@@ -33,11 +74,50 @@ static int l2_stop(cts_store *s, uint64_t id) {
     return 1;
 }
 
+static int l2_touch(cts_store *s, uint64_t id) {
+    lawn2_timer *n = timer_for(s->st, id);
+    if (!n->in_store) return 0;
+    lawn2_touch(s->l, n);
+    return 1;
+}
+
+static int l2z_touch(cts_store *s, uint64_t id) {
+    lawn2_timer *n = timer_for(s->st, id);
+    if (!n->in_store) return 0;
+    lawn2_extend(s->l, n, n->ttl);  /* its class ttl, even once re-queued */
+    return 1;
+}
+
+static void l2_stop_batch(cts_store *s, const uint64_t *ids, size_t n) {
+    lawn2_timer *nodes[256];
+    for (size_t i = 0; i < n; i += 256) {
+        size_t m = n - i < 256 ? n - i : 256;
+        for (size_t k = 0; k < m; k++) nodes[k] = timer_for(s->st, ids[i + k]);
+        lawn2_del_batch(s->l, nodes, m);
+    }
+}
+
 static uint64_t l2_tick(cts_store *s) { 
     lawn2_timer *expired_head = NULL;
     uint64_t count = lawn2_tick(s->l, &expired_head);
     return count; 
 }
+
+/* Cut due blades off as segments, then pop every node (a real caller has to
+ * visit each fired timer anyway; popping also clears in_store for stop()). */
+static uint64_t l2s_tick(cts_store *s) {
+    lawn2_segment segs[64];
+    size_t nsegs;
+    uint64_t count = 0;
+    uint64_t target = lawn2_now(s->l) + 1;
+    do {
+        count += lawn2_advance_segments(s->l, target, segs, 64, &nsegs);
+        for (size_t i = 0; i < nsegs; i++)
+            while (lawn2_seg_pop(&segs[i])) {}
+    } while (lawn2_pending(s->l));
+    return count;
+}
+
 static uint64_t l2_size(cts_store *s) { return lawn2_size(s->l); }
 
 /* Jump the clock forward with no expiry processing (staggered preload keeps
@@ -46,5 +126,30 @@ static void l2_advance(cts_store *s, uint64_t target) { lawn2_set_now(s->l, targ
 
 const cts_vtable cts_lawn2_vtable = {
     "lawn2", l2_create, l2_destroy,
-    l2_start, l2_stop, l2_tick, l2_size, l2_advance,
+    l2_start, l2_stop, l2_tick, l2_size, l2_advance, l2_touch, l2_start_batch, l2_stop_batch,
+};
+
+const cts_vtable cts_lawn2_indexed_vtable = {
+    "lawn2idx", l2i_create, l2_destroy,
+    l2_start, l2_stop, l2_tick, l2_size, l2_advance, l2_touch, l2_start_batch, l2_stop_batch,
+};
+
+const cts_vtable cts_lawn2_hybrid_vtable = {
+    "lawn2hybrid", l2h_create, l2_destroy,
+    l2_start, l2_stop, l2_tick, l2_size, l2_advance, l2_touch, l2_start_batch, l2_stop_batch,
+};
+
+const cts_vtable cts_lawn2_direct_vtable = {
+    "lawn2direct", l2d_create, l2_destroy,
+    l2_start, l2_stop, l2_tick, l2_size, l2_advance, l2_touch, l2_start_batch, l2_stop_batch,
+};
+
+const cts_vtable cts_lawn2_segment_vtable = {
+    "lawn2seg", l2_create, l2_destroy,
+    l2_start, l2_stop, l2s_tick, l2_size, l2_advance, l2_touch, l2_start_batch, l2_stop_batch,
+};
+
+const cts_vtable cts_lawn2_lazy_vtable = {
+    "lawn2lazy", l2_create, l2_destroy,
+    l2_start, l2_stop, l2_tick, l2_size, l2_advance, l2z_touch, NULL, l2_stop_batch,
 };
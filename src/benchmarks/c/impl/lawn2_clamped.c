@@ -1,7 +1,10 @@
 /* cts adapter for lawn2 with Linux-kernel-style timer-wheel TTL clamping.
- * Every start() rounds ttl up to its wheel level's bucket boundary before
- * inserting, so far-out timers lose precision the same way the kernel's
- * legacy timer wheel does. Node storage matches impl/lawn2.c. */
+ * The store is created with cfg.quant = LAWN2_QUANT_KERNEL, so every start()
+ * has its ttl rounded up to its wheel level's bucket boundary inside lawn2,
+ * and far-out timers lose precision the same way the kernel's legacy timer
+ * wheel does. clamp_timer_ttl below is the same rounding written out level
+ * by level, kept as test.c's independent reference for the policy. Node
+ * storage matches impl/lawn2.c. */
 #include "cts.h"
 #include "lawn2.h"
 #include "lawn2_clamped.h"
@@ -43,7 +46,8 @@ struct cts_store {
 
 static cts_store *l2c_create(void) {
     struct cts_store *s = calloc(1, sizeof *s);
-    s->l = lawn2_new();
+    lawn2_config cfg = { .quant = LAWN2_QUANT_KERNEL };
+    s->l = lawn2_new_config(&cfg);
     s->st = init_store();
     return s;
 }
@@ -55,7 +59,7 @@ static void l2c_destroy(cts_store *s) {
 }
 
 static void l2c_start(cts_store *s, uint64_t id, uint64_t ttl) {
-    lawn2_add(s->l, timer_for(s->st, id), clamp_timer_ttl(ttl));
+    lawn2_add(s->l, timer_for(s->st, id), ttl);
 }
 
 static int l2c_stop(cts_store *s, uint64_t id) {
@@ -78,5 +82,5 @@ static void l2c_advance(cts_store *s, uint64_t target) { lawn2_set_now(s->l, tar
 
 const cts_vtable cts_lawn2_clamped_vtable = {
     "lawn2clamp", l2c_create, l2c_destroy,
-    l2c_start, l2c_stop, l2c_tick, l2c_size, l2c_advance,
+    l2c_start, l2c_stop, l2c_tick, l2c_size, l2c_advance, NULL, NULL, NULL,
 };
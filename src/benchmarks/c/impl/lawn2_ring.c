@@ -0,0 +1,43 @@
+/* cts adapter for lawn2r, the ring-buffer-blade lawn2 variant. Like lawn2c,
+ * the store owns its id-addressed nodes, so ids map straight onto them. */
+#include "cts.h"
+#include "lawn2r.h"
+#include <stdlib.h>
+
+struct cts_store {
+    lawn2r *l;
+};
+
+static cts_store *l2r_create(void) {
+    struct cts_store *s = calloc(1, sizeof *s);
+    s->l = lawn2r_new();
+    return s;
+}
+
+static void l2r_destroy(cts_store *s) {
+    lawn2r_free(s->l);
+    free(s);
+}
+
+static void l2r_start(cts_store *s, uint64_t id, uint64_t ttl) {
+    lawn2r_add(s->l, (uint32_t)id, ttl);
+}
+
+static int l2r_stop(cts_store *s, uint64_t id) {
+    return lawn2r_del(s->l, (uint32_t)id);
+}
+
+static uint64_t l2r_tick(cts_store *s) {
+    const uint32_t *fired;
+    return lawn2r_tick(s->l, &fired);
+}
+
+static uint64_t l2r_size(cts_store *s) { return lawn2r_size(s->l); }
+
+/* Jump the clock forward with no expiry processing. Mirrors impl/lawn2.c. */
+static void l2r_advance(cts_store *s, uint64_t target) { lawn2r_set_now(s->l, target); }
+
+const cts_vtable cts_lawn2_ring_vtable = {
+    "lawn2ring", l2r_create, l2r_destroy,
+    l2r_start, l2r_stop, l2r_tick, l2r_size, l2r_advance, NULL, NULL, NULL,
+};
@@ -127,5 +127,5 @@ static void naive_advance(cts_store *s, uint64_t target) { s->now = target; }
 
 const cts_vtable cts_naive_vtable = {
     "naive", naive_create, naive_destroy,
-    naive_start, naive_stop, naive_tick, naive_size, naive_advance,
+    naive_start, naive_stop, naive_tick, naive_size, naive_advance, NULL, NULL, NULL,
 };
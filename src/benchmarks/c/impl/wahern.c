@@ -97,5 +97,5 @@ static void wahern_advance(cts_store *s, uint64_t target) {
 
 const cts_vtable cts_wahern_vtable = {
     "wahern", wahern_create, wahern_destroy,
-    wahern_start, wahern_stop, wahern_tick, wahern_size, wahern_advance,
+    wahern_start, wahern_stop, wahern_tick, wahern_size, wahern_advance, NULL, NULL, NULL,
 };
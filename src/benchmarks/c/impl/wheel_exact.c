@@ -155,5 +155,5 @@ static void we_advance(cts_store *s, uint64_t target) {
 
 const cts_vtable cts_wheel_exact_vtable = {
     "wheelexact", we_create, we_destroy,
-    we_start, we_stop, we_tick, we_size, we_advance,
+    we_start, we_stop, we_tick, we_size, we_advance, NULL, NULL, NULL,
 };
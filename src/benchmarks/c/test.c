@@ -1,7 +1,9 @@
 /* Correctness gate for the C adapters. Exit non-zero on failure. */
 #include "cts.h"
 #include "util.h"
+#include "impl/adaptive.h"
 #include "impl/lawn2_clamped.h"
+#include "lawn2.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -162,8 +164,9 @@ static void advance_matches_tick(void) {
 }
 
 /* Pure-function invariants for the Linux-kernel-style TTL clamp used by
- * lawn2clamp (impl/lawn2_clamped.c): never fires early, and an already
- * bucket-aligned ttl is a fixed point. Covers every level, including the
+ * lawn2clamp (impl/lawn2_clamped.c): never fires early, an already
+ * bucket-aligned ttl is a fixed point, and lawn2's closed-form
+ * LAWN2_QUANT_KERNEL policy agrees with the level-by-level loop. Covers every level, including the
  * level-8 catch-all, without ticking a store through tens of millions of
  * ticks. */
 static void clamp_math(void) {
@@ -176,14 +179,17 @@ static void clamp_math(void) {
         uint64_t ttl = ttls[k];
         uint64_t clamped = clamp_timer_ttl(ttl);
         uint64_t reclamped = clamp_timer_ttl(clamped);
-        if (clamped < ttl || reclamped != clamped) {
-            fprintf(stderr, "FAIL clamp_math: ttl=%llu clamp=%llu clamp(clamp)=%llu\n",
+        uint64_t policy = lawn2_quantize(LAWN2_QUANT_KERNEL, 0, ttl);
+        if (clamped < ttl || reclamped != clamped || policy != clamped) {
+            fprintf(stderr, "FAIL clamp_math: ttl=%llu clamp=%llu clamp(clamp)=%llu "
+                    "lawn2_quantize=%llu\n",
                     (unsigned long long)ttl, (unsigned long long)clamped,
-                    (unsigned long long)reclamped);
+                    (unsigned long long)reclamped, (unsigned long long)policy);
             exit(1);
         }
     }
-    printf("  clamp_timer_ttl: %zu ttls never fire early and are bucket-stable\n",
+    printf("  clamp_timer_ttl: %zu ttls never fire early, are bucket-stable and "
+           "match LAWN2_QUANT_KERNEL\n",
            sizeof ttls / sizeof ttls[0]);
 }
 
@@ -213,6 +219,64 @@ static void clamp_wiring(void) {
            sizeof ttls / sizeof ttls[0]);
 }
 
+/* "adaptive" must actually cross over both ways and stay exact while it
+ * does. A tick-heavy phase over 2000 distinct ttls prices lawn2's blade scan
+ * above the wheel; an op-only phase of single-ttl restarts prices it below.
+ * Every stop() result, per-tick fired count and size() is checked against a
+ * plain lawn2 store fed the same operations, migrations included. */
+static void adaptive_switches(void) {
+    const cts_vtable *vt = &cts_adaptive_vtable, *rv = &cts_lawn2_vtable;
+    const uint64_t n = 20000;
+    cts_store *s = vt->create(), *r = rv->create();
+    rng_t rng;
+    rng_seed(&rng, 5);
+    uint64_t next = 0, t = 0;
+#define BOTH_TICK() do { \
+        uint64_t fs = vt->tick(s), fr = rv->tick(r); t++; \
+        if (fs != fr || vt->size(s) != rv->size(r)) { \
+            fprintf(stderr, "FAIL adaptive_switches: tick %llu fired %llu/%llu size %llu/%llu\n", \
+                    (unsigned long long)t, (unsigned long long)fs, (unsigned long long)fr, \
+                    (unsigned long long)vt->size(s), (unsigned long long)rv->size(r)); \
+            exit(1); \
+        } } while (0)
+    for (; next < n; next++) {
+        vt->start(s, next, 1000 + next % 2000);
+        rv->start(r, next, 1000 + next % 2000);
+    }
+    for (int k = 0; k < 10000; k++, next++) {
+        vt->start(s, next, 1000 + next % 2000);
+        rv->start(r, next, 1000 + next % 2000);
+        BOTH_TICK();
+    }
+    if (strcmp(cts_adaptive_engine(s), "wahern")) {
+        fprintf(stderr, "FAIL adaptive_switches: tick-heavy phase left it on %s\n",
+                cts_adaptive_engine(s));
+        exit(1);
+    }
+    for (int k = 0; k < 300000; k++) {
+        uint64_t id = rng_u64(&rng) % next;
+        int a = vt->stop(s, id), b = rv->stop(r, id);
+        if (a != b) {
+            fprintf(stderr, "FAIL adaptive_switches: stop(%llu) %d vs %d\n",
+                    (unsigned long long)id, a, b);
+            exit(1);
+        }
+        vt->start(s, id, 5000);
+        rv->start(r, id, 5000);
+    }
+    if (strcmp(cts_adaptive_engine(s), "lawn2")) {
+        fprintf(stderr, "FAIL adaptive_switches: op-only phase left it on %s\n",
+                cts_adaptive_engine(s));
+        exit(1);
+    }
+    while (rv->size(r)) BOTH_TICK();
+#undef BOTH_TICK
+    printf("  adaptive: %llu migrations (lawn2 -> wahern -> lawn2), exact throughout\n",
+           (unsigned long long)cts_adaptive_migrations(s));
+    vt->destroy(s);
+    rv->destroy(r);
+}
+
 int main(void) {
     printf("C correctness gate (%d impls: ", cts_nalgos);
     for (int a = 0; a < cts_nalgos; a++) printf("%s%s", cts_algos[a]->name,
@@ -223,6 +287,7 @@ int main(void) {
     advance_matches_tick();
     clamp_math();
     clamp_wiring();
+    adaptive_switches();
     printf("ALL C CORRECTNESS TESTS PASSED\n");
     return 0;
 }
@@ -14,11 +14,19 @@ mstime_t current_time_ms(void) {
 const cts_vtable *const cts_algos[] = {
     &cts_lawn_vtable,
     &cts_lawn2_vtable,
+    &cts_lawn2_indexed_vtable,
+    &cts_lawn2_hybrid_vtable,
+    &cts_lawn2_direct_vtable,
+    &cts_lawn2_segment_vtable,
+    &cts_lawn2_lazy_vtable,
+    &cts_lawn2_compact_vtable,
+    &cts_lawn2_ring_vtable,
     &cts_lawn2_clamped_vtable,
     &cts_wahern_vtable,
     &cts_naive_vtable,
     &cts_heap_vtable,
     &cts_wheel_exact_vtable,
+    &cts_adaptive_vtable,
 };
 const int cts_nalgos = (int)(sizeof(cts_algos) / sizeof(cts_algos[0]));
 
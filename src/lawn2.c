@@ -1,45 +1,343 @@
 /* lawn2 implementation - see lawn2.h. */
 #include "lawn2.h"
 
+#include <string.h>
+
 #define GOLDEN 0x9E3779B97F4A7C15ULL
 
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
 /* One TTL blade: head is the earliest expiry (queue is self-sorted because
- * same-TTL timers arrive in expiry order). Empty-but-used slots linger until a
- * grow rehashes them out; the same TTLs reappear in practice, so t stays small.
- * live_prev/live_next thread this blade into lawn2.live_head whenever
- * head != NULL, so a tick only visits buckets that actually hold timers. */
+ * same-TTL timers arrive in expiry order). Blades live in lawn2.blades and
+ * never move index once created, so a node can cache its blade's index and
+ * delete without hashing; the TTL table only maps ttl -> index. Drained
+ * blades linger (the same TTLs usually reappear) unless cfg.idle_ticks is
+ * set: then a blade that stays empty that long is reclaimed, its slot
+ * becomes a tombstone and its index goes on a free list for reuse.
+ * This is the cold half of a hot/cold split: while head != NULL the blade
+ * also owns slot `pos` of the dense hot arrays (lawn2.live_exp/live_blade),
+ * so a tick streams over head expirations instead of chasing blade pointers.
+ * Under LAWN2_INDEXED the heap replaces the hot arrays and pos is this
+ * blade's slot in the heap. In hybrid mode (cfg.cold_max) both exist: a
+ * cold blade, one holding few timers, keeps its entry in the heap, and is
+ * promoted to the hot arrays once it fills up. */
 typedef struct blade {
     uint64_t   ttl;
-    int        used;
     lawn2_timer *head, *tail;
-    struct blade *live_prev, *live_next;
+    uint64_t   len;                   /* linked timers: a fully due blade is cut in O(1) */
+    uint64_t   nperiodic;             /* LAWN2_TIMER_PERIODIC timers among them */
+    uint64_t   nstale;                /* LAWN2_TIMER_STALE ones; never the head */
+    uint64_t   off;                   /* added to every node's expiration: lawn2_retime_ttl */
+    uint32_t   pos;
+    uint32_t   idle_prev, idle_next;  /* idle FIFO links; idle_next is the free-list link once reclaimed */
+    uint32_t   cold;                  /* hybrid mode: its entry is in the heap, not the hot arrays */
+    uint64_t   idle_since;            /* tick it drained at, NOT_IDLE while off the idle FIFO */
 } blade;
 
+#define BLADE_NIL UINT32_MAX
+#define NOT_IDLE  UINT64_MAX
+
+/* A linked node's real expiration. Stored relative to its blade's offset so
+ * that lawn2_retime_ttl moves a whole blade without touching its nodes;
+ * off is 0 until then, and a node leaving the store is made absolute again
+ * (leave()). */
+static inline uint64_t exp_of(const blade *b, const lawn2_timer *n) {
+    return n->expiration + b->off;
+}
+
+/* n leaves b: give it back its absolute expiration and its TTL, which is
+ * b's unless n was re-queued there from another (LAWN2_TIMER_AWAY). */
+static inline void leave(const blade *b, lawn2_timer *n) {
+    n->expiration += b->off;
+    if (!(n->flags & LAWN2_TIMER_AWAY)) n->ttl = b->ttl;
+    n->flags &= ~LAWN2_TIMER_AWAY;
+}
+
+/* TTL table slot (open addressing): ttl -> index into lawn2.blades. A
+ * reclaimed blade leaves a tombstone so later probes still walk past it. */
+typedef struct slot {
+    uint64_t ttl;
+    uint32_t blade;
+    uint32_t state;
+} slot;
+
+#define SLOT_EMPTY 0
+#define SLOT_USED  1
+#define SLOT_TOMB  2
+
+/* Heap entry: the key is a copy of the blade head's expiration so sifting
+ * never dereferences a node. */
+typedef struct heap_ent {
+    uint64_t key;
+    uint32_t blade;
+} heap_ent;
+
 struct lawn2 {
     uint64_t now;
-    blade  *tab;
+    slot    *tab;
     size_t   cap;            /* power of two */
     unsigned bits;           /* cap == 1u << bits */
-    size_t   count;          /* used slots (distinct TTLs seen) */
+    uint32_t nused, ntomb;   /* SLOT_USED (== hashed blades held, both tables) / SLOT_TOMB in tab */
+    unsigned min_bits;       /* floor for shrinking, raised by lawn2_reserve */
+    slot    *otab;           /* previous table while a resize migrates, else NULL */
+    unsigned obits;
+    size_t   mig;            /* otab slots below this have moved to tab */
+    uint32_t *direct;        /* cfg.direct_max: blade of each TTL below it, BLADE_NIL if none */
+    uint64_t direct_max;
+    uint32_t ndirect;        /* blades held in direct */
+    blade   *blades;         /* stable-index blade array; count == high-water index */
+    uint32_t count, blades_cap;
+    uint32_t free_blade;     /* reclaimed indices, linked through idle_next */
+    uint64_t idle_ticks;     /* cfg.idle_ticks, 0: never reclaim */
+    uint64_t disorder;       /* cfg.disorder: lawn2_add_at's lateness bound */
+    unsigned quant;          /* cfg.quant policy, LAWN2_QUANT_NONE: exact TTLs */
+    uint64_t quant_param;    /* cfg.quant_param, RELATIVE: bits kept instead */
+    uint64_t quant_rounded, quant_err_sum, quant_err_max, quant_ppm_max;
+    uint32_t idle_head, idle_tail; /* empty blades, oldest drain first */
+    uint64_t reclaimed;
     uint64_t live;
-    uint64_t next_expiration;/* lower bound on earliest live expiry */
-    blade   *live_head;      /* head of the non-empty-bucket list */
+    uint64_t next_expiration;/* lower bound on earliest live expiry (exact if indexed) */
+    uint64_t *live_exp;      /* hot: head expiration of each non-empty blade */
+    uint32_t *live_blade;    /* parallel to live_exp; capacity blades_cap */
+    uint32_t nlive;          /* non-empty blades */
+    int      simd;           /* use the AVX2 scan kernels */
+    unsigned flags;          /* LAWN2_* from lawn2_config */
+    heap_ent *heap;          /* LAWN2_INDEXED: min-heap of non-empty blades; hybrid: the cold ones */
+    uint32_t hlen;           /* heap entries; capacity blades_cap */
+    uint64_t cold_max;       /* cfg.cold_max, 0: not hybrid */
+    uint64_t promoted, demoted;
+    heap_ent *merge;         /* scan mode: lawn2_advance_ordered's scratch heap, lazily */
+    heap_ent *ix;            /* held TTLs sorted, key = ttl; built by lawn2_add_slack */
+    uint32_t nix, ix_cap;
+    uint64_t slack_adds, slack_coalesced, slack_late_sum, slack_late_max;
+    lawn2_timer *deferred;   /* stale timers waiting for flush_deferred(), via ->next */
+    lawn2_timer **rearmed;   /* periodic timers the last Poll fired and re-armed */
+    size_t   nrearmed, rearmed_cap;
+    int      pending;        /* a budgeted Poll stopped with timers still due */
+    uint32_t drain;          /* hot slot it stopped at (scan mode) */
 };
 
-/* Splice b into the live list; b must currently be out of it (head was NULL). */
-static void live_link(lawn2 *l, blade *b) {
-    b->live_prev = NULL;
-    b->live_next = l->live_head;
-    if (l->live_head) l->live_head->live_prev = b;
-    l->live_head = b;
+/* Append blade bi to the hot arrays; it just became non-empty. */
+static void live_link(lawn2 *l, uint32_t bi) {
+    blade *b = &l->blades[bi];
+    b->pos = l->nlive++;
+    l->live_exp[b->pos] = exp_of(b, b->head);
+    l->live_blade[b->pos] = bi;
 }
 
-/* Remove b from the live list; b must currently be in it (head is now NULL). */
+/* Swap-remove b from the hot arrays; b just drained to empty (or, in
+ * hybrid mode, is being demoted: either way it is cold from here on). */
 static void live_unlink(lawn2 *l, blade *b) {
-    if (b->live_prev) b->live_prev->live_next = b->live_next;
-    else l->live_head = b->live_next;
-    if (b->live_next) b->live_next->live_prev = b->live_prev;
-    b->live_prev = b->live_next = NULL;
+    uint32_t i = b->pos, last = --l->nlive;
+    b->cold = l->cold_max != 0;
+    if (i != last) {
+        l->live_exp[i] = l->live_exp[last];
+        l->live_blade[i] = l->live_blade[last];
+        l->blades[l->live_blade[i]].pos = i;
+        if (i < l->drain) l->drain = i;  /* an unscanned blade moved behind the cursor */
+    }
+}
+
+// ##################### due-blade scan kernels ########################
+/* Both kernels stream over the dense live_exp[] array. AVX2 compares four
+ * heads against `now` per instruction and turns the result into a due-mask;
+ * it is compiled via a target attribute and picked at runtime, so the
+ * default (non -mavx2) build still uses it where the CPU has it. Anything
+ * else gets the scalar loops. */
+
+/* First i in [from, n) with e[i] <= now, or n. */
+static size_t first_due_scalar(const uint64_t *e, size_t from, size_t n, uint64_t now) {
+    for (size_t i = from; i < n; i++)
+        if (e[i] <= now) return i;
+    return n;
+}
+
+static uint64_t min_exp_scalar(const uint64_t *e, size_t n) {
+    uint64_t m = UINT64_MAX;
+    for (size_t i = 0; i < n; i++)
+        if (e[i] < m) m = e[i];
+    return m;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LAWN2_HAVE_AVX2 1
+#include <immintrin.h>
+
+/* AVX2 only has a signed 64-bit compare: flipping the sign bit of both
+ * operands turns it into the unsigned one. */
+#define SIGN64 0x8000000000000000ULL
+
+__attribute__((target("avx2")))
+static size_t first_due_avx2(const uint64_t *e, size_t from, size_t n, uint64_t now) {
+    const __m256i bias = _mm256_set1_epi64x((long long)SIGN64);
+    const __m256i vnow = _mm256_xor_si256(_mm256_set1_epi64x((long long)now), bias);
+    size_t i = from;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(e + i)), bias);
+        /* lane set where e > now, i.e. not due */
+        unsigned later = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, vnow)));
+        unsigned due = ~later & 0xFu;
+        if (due) return i + (size_t)__builtin_ctz(due);
+    }
+    return first_due_scalar(e, i, n, now);
+}
+
+__attribute__((target("avx2")))
+static uint64_t min_exp_avx2(const uint64_t *e, size_t n) {
+    const __m256i bias = _mm256_set1_epi64x((long long)SIGN64);
+    __m256i m = _mm256_set1_epi64x((long long)(UINT64_MAX ^ SIGN64));
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(e + i)), bias);
+        m = _mm256_blendv_epi8(m, v, _mm256_cmpgt_epi64(m, v));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_xor_si256(m, bias));
+    uint64_t r = min_exp_scalar(e + i, n - i);
+    for (int k = 0; k < 4; k++)
+        if (lanes[k] < r) r = lanes[k];
+    return r;
+}
+#endif
+
+static uint32_t first_due(const lawn2 *l, uint32_t from, uint64_t now) {
+#ifdef LAWN2_HAVE_AVX2
+    if (l->simd) return (uint32_t)first_due_avx2(l->live_exp, from, l->nlive, now);
+#endif
+    return (uint32_t)first_due_scalar(l->live_exp, from, l->nlive, now);
+}
+
+static uint64_t min_live_exp(const lawn2 *l) {
+#ifdef LAWN2_HAVE_AVX2
+    if (l->simd) return min_exp_avx2(l->live_exp, l->nlive);
+#endif
+    return min_exp_scalar(l->live_exp, l->nlive);
+}
+
+// ##################### blade-head heap (LAWN2_INDEXED) ###############
+/* Also the overflow heap of hybrid mode, holding the cold blades only. */
+
+static void heap_set(lawn2 *l, uint32_t i, heap_ent e) {
+    l->heap[i] = e;
+    l->blades[e.blade].pos = i;
+}
+
+static void sift_up(lawn2 *l, uint32_t i) {
+    heap_ent e = l->heap[i];
+    while (i) {
+        uint32_t p = (i - 1) / 2;
+        if (l->heap[p].key <= e.key) break;
+        heap_set(l, i, l->heap[p]);
+        i = p;
+    }
+    heap_set(l, i, e);
+}
+
+static void sift_down(lawn2 *l, uint32_t i) {
+    heap_ent e = l->heap[i];
+    for (;;) {
+        size_t c = 2 * (size_t)i + 1;
+        if (c >= l->hlen) break;
+        if (c + 1 < l->hlen && l->heap[c + 1].key < l->heap[c].key) c++;
+        if (e.key <= l->heap[c].key) break;
+        heap_set(l, i, l->heap[c]);
+        i = (uint32_t)c;
+    }
+    heap_set(l, i, e);
+}
+
+/* The heap top is the exact earliest expiry, so keep next_expiration equal
+ * to it after every heap change. In hybrid mode the hot arrays hold the
+ * rest, so next_expiration stays a lower bound: only ever lower it. */
+static void heap_sync_next(lawn2 *l) {
+    if (l->cold_max) {
+        if (l->hlen && l->heap[0].key < l->next_expiration) l->next_expiration = l->heap[0].key;
+        return;
+    }
+    l->next_expiration = l->hlen ? l->heap[0].key : UINT64_MAX;
+}
+
+/* Blade bi just became non-empty. */
+static void heap_push(lawn2 *l, uint32_t bi) {
+    l->heap[l->hlen] = (heap_ent){ exp_of(&l->blades[bi], l->blades[bi].head), bi };
+    sift_up(l, l->hlen++);
+    heap_sync_next(l);
+}
+
+/* Take b's entry out of the heap. */
+static void heap_remove(lawn2 *l, blade *b) {
+    uint32_t i = b->pos;
+    heap_ent last = l->heap[--l->hlen];
+    if (i < l->hlen) {
+        heap_set(l, i, last);
+        sift_up(l, i);
+        sift_down(l, l->blades[last.blade].pos);
+    }
+}
+
+/* b's head changed (it only ever moves later) or b drained to empty. */
+static void heap_update(lawn2 *l, blade *b) {
+    if (b->head) {
+        l->heap[b->pos].key = exp_of(b, b->head);
+        sift_down(l, b->pos);
+    } else {
+        heap_remove(l, b);
+    }
+    heap_sync_next(l);
+}
+
+/* b's head key moved either way (lawn2_retime_ttl). */
+static void heap_rekey(lawn2 *l, blade *b) {
+    l->heap[b->pos].key = exp_of(b, b->head);
+    sift_up(l, b->pos);
+    sift_down(l, b->pos);
+    heap_sync_next(l);
+}
+
+// ##################### hybrid mode (cfg.cold_max) ####################
+/* A long tail of near-unique TTLs (client-supplied deadlines) gives one
+ * blade per timer, and a scan-mode Poll streams over every one of them.
+ * Hybrid mode keeps such cold blades out of the hot arrays: their entries
+ * sit in the blade heap instead, which a Poll only pops when its top is
+ * due. Timers never leave their blade, so every per-timer operation is
+ * unchanged; only the blade's hot entry lives elsewhere. A new or drained
+ * blade starts cold. Whatever grows a blade promotes it to the hot arrays
+ * once it reaches cold_max timers, and a Poll demotes one it leaves under
+ * half that (the gap keeps a TTL hovering at the threshold from flapping). */
+
+/* Does b keep its hot entry in the heap rather than the hot arrays? */
+static inline int heaped(const lawn2 *l, const blade *b) {
+    return (l->flags & LAWN2_INDEXED) || b->cold;
+}
+
+/* Scan mode: a fresh lower bound on the earliest expiry, both halves. */
+static uint64_t next_bound(const lawn2 *l) {
+    uint64_t m = min_live_exp(l);
+    if (l->cold_max && l->hlen && l->heap[0].key < m) m = l->heap[0].key;
+    return m;
+}
+
+/* Blade bi (non-empty) just grew: if it is cold and now holds cold_max
+ * timers, move its entry from the heap to the hot arrays. Its heap key
+ * already bounds next_expiration. */
+static inline void promote_if_full(lawn2 *l, uint32_t bi) {
+    blade *b = &l->blades[bi];
+    if (!b->cold || b->len < l->cold_max) return;
+    heap_remove(l, b);
+    b->cold = 0;
+    l->promoted++;
+    live_link(l, bi);
+}
+
+/* Hot blade bi (non-empty, head not due) has too few timers left. */
+static void demote(lawn2 *l, uint32_t bi) {
+    live_unlink(l, &l->blades[bi]);
+    heap_push(l, bi);
+    l->demoted++;
 }
 
 
@@ -67,6 +365,10 @@ lawn2_timer *timer_for(timer_store *s, uint64_t id) {
     return &s->blocks[block_index][id & BLK_MASK];
 }
 
+void reserve_store(timer_store *s, uint64_t ids) {
+    if (ids) timer_for(s, ids - 1);   /* allocates every block up to it */
+}
+
 timer_store *init_store(void) {
     timer_store *s = calloc(1, sizeof *s);
     return s;
@@ -80,146 +382,1374 @@ void destroy_store(timer_store *s) {
 
 // ###################### internal datastructure managment #############
 
-static blade *find_slot(lawn2 *l, uint64_t ttl) {
-    size_t mask = l->cap - 1;
-    size_t i = (size_t)((ttl * GOLDEN) >> (64 - l->bits));
+/* ttl's SLOT_USED slot in tab (2^bits slots) if present, else where to
+ * insert it: the first tombstone on its probe path, or the empty slot that
+ * ended the probe. */
+static slot *probe(slot *tab, unsigned bits, uint64_t ttl) {
+    size_t mask = ((size_t)1 << bits) - 1;
+    size_t i = (size_t)((ttl * GOLDEN) >> (64 - bits));
+    slot *tomb = NULL;
     for (;;) {
-        blade *b = &l->tab[i & mask];
-        if (!b->used || b->ttl == ttl) return b;
+        slot *e = &tab[i & mask];
+        if (e->state == SLOT_EMPTY) return tomb ? tomb : e;
+        if (e->state == SLOT_TOMB) {
+            if (!tomb) tomb = e;
+        } else if (e->ttl == ttl) {
+            return e;
+        }
         i++;
     }
 }
 
-static void grow(lawn2 *l) {
-    unsigned nb = l->bits + 1;
-    size_t ncap = (size_t)1 << nb;
-    blade *ot = l->tab;
-    size_t ocap = l->cap;
-    l->tab = calloc(ncap, sizeof(blade));
-    l->cap = ncap;
-    l->bits = nb;
-    /* Rebuild the live list from scratch: the copied live_prev/live_next
-     * below still point into `ot`, which is about to be freed. */
-    l->live_head = NULL;
-    size_t new_count = 0;
-    for (size_t i = 0; i < ocap; i++) {
-        if (ot[i].used) {
-            blade *b = find_slot(l, ot[i].ttl);  /* empty in the new table */
-            *b = ot[i];                           /* carries head/tail ptrs */
-            b->live_prev = b->live_next = NULL;
-            if (b->head) live_link(l, b);
-            new_count++;
+/* Resizing is incremental: rehash() swaps in an empty table and keeps the
+ * old one in otab, and every later blade_for()/Poll moves the next
+ * MIGRATE_STEP old slots across, so no single insert pays for the whole
+ * table. Until then a TTL may sit in either table; new TTLs always go to
+ * tab. Moved-out old slots become tombstones so old probe paths stay
+ * intact. Blades never move index, so only (ttl, index) pairs move: the
+ * heap, the hot arrays and every node's cached blade index stay valid. */
+#define MIGRATE_STEP 16
+
+static void migrate(lawn2 *l, size_t steps) {
+    size_t ocap = (size_t)1 << l->obits;
+    for (; steps && l->mig < ocap; steps--) {
+        slot *o = &l->otab[l->mig++];
+        if (o->state != SLOT_USED) continue;
+        slot *e = probe(l->tab, l->bits, o->ttl);   /* never present in tab yet */
+        if (e->state == SLOT_TOMB) l->ntomb--;
+        *e = *o;
+        o->state = SLOT_TOMB;
+    }
+    if (l->mig == ocap) {
+        free(l->otab);
+        l->otab = NULL;
+    }
+}
+
+/* Switch to a 2^bits-slot table (larger, same or smaller; tombstones are
+ * dropped on the way), finishing any migration still in flight first. */
+static void rehash(lawn2 *l, unsigned bits) {
+    if (l->otab) migrate(l, SIZE_MAX);
+    l->otab = l->tab;
+    l->obits = l->bits;
+    l->mig = 0;
+    l->bits = bits;
+    l->cap = (size_t)1 << l->bits;
+    l->tab = calloc(l->cap, sizeof(slot));
+    l->ntomb = 0;
+    migrate(l, MIGRATE_STEP);
+}
+
+/* Non-empty blades <= blades, so the heap/hot arrays grow in step. */
+static void grow_blades(lawn2 *l, uint32_t cap) {
+    l->blades_cap = cap;
+    l->blades = realloc(l->blades, l->blades_cap * sizeof *l->blades);
+    if ((l->flags & LAWN2_INDEXED) || l->cold_max)
+        l->heap = realloc(l->heap, l->blades_cap * sizeof *l->heap);
+    if (!(l->flags & LAWN2_INDEXED)) {
+        l->live_exp = realloc(l->live_exp, l->blades_cap * sizeof *l->live_exp);
+        l->live_blade = realloc(l->live_blade, l->blades_cap * sizeof *l->live_blade);
+        if (l->merge) l->merge = realloc(l->merge, l->blades_cap * sizeof *l->merge);
+    }
+}
+
+// ##################### ordered TTL index ############################
+/* lawn2_add_slack asks for the smallest held TTL at or above x, which the
+ * hash table cannot answer. The index keeps every held TTL sorted with its
+ * blade. It is built by the first lawn2_add_slack and only maintained after
+ * that, so stores that never use slack pay nothing. A new or dropped TTL
+ * costs a binary search and a memmove: TTLs come and go far less often than
+ * timers do. */
+
+/* First index entry with ttl >= x. */
+static uint32_t ix_lower(const lawn2 *l, uint64_t x) {
+    uint32_t lo = 0, hi = l->nix;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (l->ix[mid].key < x) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* ttl is now held by blade bi (a new TTL, or a held one re-pointed). */
+static void ix_set(lawn2 *l, uint64_t ttl, uint32_t bi) {
+    if (!l->ix) return;
+    uint32_t i = ix_lower(l, ttl);
+    if (i < l->nix && l->ix[i].key == ttl) {
+        l->ix[i].blade = bi;
+        return;
+    }
+    if (l->nix == l->ix_cap) {
+        l->ix_cap *= 2;
+        l->ix = realloc(l->ix, l->ix_cap * sizeof *l->ix);
+    }
+    memmove(&l->ix[i + 1], &l->ix[i], (l->nix - i) * sizeof *l->ix);
+    l->ix[i] = (heap_ent){ ttl, bi };
+    l->nix++;
+}
+
+/* ttl (held) is no longer. */
+static void ix_drop(lawn2 *l, uint64_t ttl) {
+    if (!l->ix) return;
+    uint32_t i = ix_lower(l, ttl);
+    memmove(&l->ix[i], &l->ix[i + 1], (l->nix - i - 1) * sizeof *l->ix);
+    l->nix--;
+}
+
+static int ix_cmp(const void *a, const void *b) {
+    uint64_t x = ((const heap_ent *)a)->key, y = ((const heap_ent *)b)->key;
+    return x < y ? -1 : x > y;
+}
+
+/* Held TTLs are the direct entries plus exactly the SLOT_USED slots of both
+ * tables (a migrated old slot is a tombstone). */
+static void ix_build(lawn2 *l) {
+    uint32_t held = l->nused + l->ndirect;
+    l->ix_cap = held > 16 ? held : 16;
+    l->ix = malloc(l->ix_cap * sizeof *l->ix);
+    l->nix = 0;
+    for (uint64_t ttl = 0; l->ndirect && ttl < l->direct_max; ttl++)
+        if (l->direct[ttl] != BLADE_NIL) l->ix[l->nix++] = (heap_ent){ ttl, l->direct[ttl] };
+    for (int t = 0; t < 2; t++) {
+        slot *tab = t ? l->otab : l->tab;
+        size_t cap = tab ? (size_t)1 << (t ? l->obits : l->bits) : 0;
+        for (size_t i = 0; i < cap; i++)
+            if (tab[i].state == SLOT_USED) l->ix[l->nix++] = (heap_ent){ tab[i].ttl, tab[i].blade };
+    }
+    qsort(l->ix, l->nix, sizeof *l->ix, ix_cmp);
+}
+
+// ##################### blade lookup ###############################
+/* TTL -> blade index. A TTL below cfg.direct_max indexes l->direct, a flat
+ * array: no multiply, no probe, no load-factor check. Any other goes through
+ * the hash table. A cache of recent lookups in front of the table does not
+ * pay: a dominant TTL's slot already sits in the CPU cache, and its hit/miss
+ * branch mispredicts on every other TTL. */
+
+/* A new, empty blade for ttl (reusing a reclaimed index when there is one). */
+static uint32_t blade_new(lawn2 *l, uint64_t ttl) {
+    uint32_t bi;
+    if (l->free_blade != BLADE_NIL) {
+        bi = l->free_blade;
+        l->free_blade = l->blades[bi].idle_next;
+    } else {
+        if (l->count == l->blades_cap) grow_blades(l, l->blades_cap * 2);
+        bi = l->count++;
+    }
+    l->blades[bi] = (blade){ ttl, NULL, NULL, 0, 0, 0, 0, 0, BLADE_NIL, BLADE_NIL, l->cold_max != 0, NOT_IDLE };
+    ix_set(l, ttl, bi);
+    return bi;
+}
+
+/* ttl's blade in the hash table, created empty on first sight. */
+static uint32_t blade_hashed(lawn2 *l, uint64_t ttl) {
+    if (l->otab) migrate(l, MIGRATE_STEP);
+    if (((size_t)l->nused + l->ntomb + 1) * 10 >= l->cap * 7) {  /* keep load < 0.7 */
+        /* grow if live slots alone are past half of that, else just purge tombstones */
+        rehash(l, ((size_t)l->nused + 1) * 20 >= l->cap * 7 ? l->bits + 1 : l->bits);
+    }
+    slot *e = probe(l->tab, l->bits, ttl);
+    if (e->state == SLOT_USED) return e->blade;
+    uint32_t bi;
+    slot *o = l->otab ? probe(l->otab, l->obits, ttl) : NULL;
+    if (o && o->state == SLOT_USED) {
+        bi = o->blade;                          /* not migrated yet: move it now */
+        o->state = SLOT_TOMB;
+    } else {
+        bi = blade_new(l, ttl);
+        l->nused++;
+    }
+    if (e->state == SLOT_TOMB) l->ntomb--;
+    e->state = SLOT_USED;
+    e->ttl = ttl;
+    e->blade = bi;
+    return bi;
+}
+
+/* Index of ttl's blade, created empty on first sight. */
+static uint32_t blade_for(lawn2 *l, uint64_t ttl) {
+    if (ttl < l->direct_max) {
+        if (l->direct[ttl] == BLADE_NIL) {
+            l->direct[ttl] = blade_new(l, ttl);
+            l->ndirect++;
         }
+        return l->direct[ttl];
+    }
+    return blade_hashed(l, ttl);
+}
+
+/* ttl's blade index, or BLADE_NIL if none is held; never creates one. */
+static uint32_t blade_find(lawn2 *l, uint64_t ttl) {
+    if (ttl < l->direct_max) return l->direct[ttl];
+    slot *e = probe(l->tab, l->bits, ttl);
+    if (e->state != SLOT_USED && l->otab) e = probe(l->otab, l->obits, ttl);
+    return e->state == SLOT_USED ? e->blade : BLADE_NIL;
+}
+
+// ##################### idle blade reclamation ########################
+/* Empty blades sit on a FIFO in drain order (l->now only moves forward, so
+ * that is also idle_since order). A blade that refills leaves it in O(1);
+ * one still on it idle_ticks after draining is reclaimed at the next Poll. */
+
+/* ttl (held) is no longer: clear its direct entry, or tombstone its slot
+ * (in one of the two tables). */
+static void slot_drop(lawn2 *l, uint64_t ttl) {
+    ix_drop(l, ttl);
+    if (ttl < l->direct_max) {
+        l->direct[ttl] = BLADE_NIL;
+        l->ndirect--;
+        return;
+    }
+    slot *e = probe(l->tab, l->bits, ttl);
+    if (e->state == SLOT_USED) l->ntomb++;
+    else e = probe(l->otab, l->obits, ttl);     /* held, so not yet migrated */
+    e->state = SLOT_TOMB;
+    l->nused--;
+}
+
+/* Blade bi just drained to empty. */
+static void idle_push(lawn2 *l, uint32_t bi) {
+    if (!l->idle_ticks) return;
+    blade *b = &l->blades[bi];
+    b->idle_since = l->now;
+    b->idle_prev = l->idle_tail;
+    b->idle_next = BLADE_NIL;
+    if (l->idle_tail != BLADE_NIL) l->blades[l->idle_tail].idle_next = bi;
+    else l->idle_head = bi;
+    l->idle_tail = bi;
+}
+
+/* b is about to refill (or be reclaimed). */
+static void idle_unlink(lawn2 *l, blade *b) {
+    if (b->idle_since == NOT_IDLE) return;
+    if (b->idle_prev != BLADE_NIL) l->blades[b->idle_prev].idle_next = b->idle_next;
+    else l->idle_head = b->idle_next;
+    if (b->idle_next != BLADE_NIL) l->blades[b->idle_next].idle_prev = b->idle_prev;
+    else l->idle_tail = b->idle_prev;
+    b->idle_since = NOT_IDLE;
+}
+
+/* Reclaim every blade idle for idle_ticks or more, then shrink the table
+ * once it is under a quarter of its 0.7 load cap (hysteresis vs the grow). */
+static void reap_idle(lawn2 *l) {
+    while (l->idle_head != BLADE_NIL) {
+        uint32_t bi = l->idle_head;
+        blade *b = &l->blades[bi];
+        if (l->now - b->idle_since < l->idle_ticks) break;
+        idle_unlink(l, b);
+        slot_drop(l, b->ttl);
+        b->idle_next = l->free_blade;
+        l->free_blade = bi;
+        l->reclaimed++;
+    }
+    if (l->otab) return;                        /* shrink once the last resize is done */
+    unsigned bits = l->bits;
+    while (bits > l->min_bits && (size_t)l->nused * 40 < ((size_t)1 << bits) * 7) bits--;
+    if (bits != l->bits) rehash(l, bits);
+}
+
+// ##################### TTL quantization ############################
+/* Rounding TTLs up onto a coarser grid collapses the TTL set, so there are
+ * fewer blades to scan and each is longer. Always up: a timer may fire
+ * late, never early. Every policy is idempotent (a rounded TTL rounds to
+ * itself), so TTLs on the grid keep their blade. */
+
+/* Kernel timer wheel levels (as in Linux kernel/time/timer.c): 64 buckets
+ * per level, each level 8x coarser, 9 levels. */
+#define LVL_BITS      6
+#define LVL_CLK_SHIFT 3
+#define LVL_DEPTH     9
+
+static inline unsigned bitlen(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 64 - (unsigned)__builtin_clzll(x) : 0;
+#else
+    unsigned n = 0;
+    for (; x; x >>= 1) n++;
+    return n;
+#endif
+}
+
+/* Round ttl up to a multiple of 2^shift (saturating instead of wrapping). */
+static inline uint64_t round_up_pow2(uint64_t ttl, unsigned shift) {
+    uint64_t mask = (1ULL << shift) - 1;
+    return ttl > UINT64_MAX - mask ? ttl : (ttl + mask) & ~mask;
+}
+
+/* RELATIVE keeps the top b significant bits of a TTL: the round-up is
+ * below 2^(len-b) for a TTL of at least 2^(len-1), an error under 2^(1-b).
+ * Smallest b that keeps it within ppm parts per million (0: exact). */
+static unsigned quant_bits(uint64_t ppm) {
+    if (!ppm) return 64;
+    unsigned b = 1;
+    while ((ppm << (b - 1)) < 1000000) b++;
+    return b;
+}
+
+static inline uint64_t quantize(unsigned policy, uint64_t param, uint64_t ttl) {
+    switch (policy) {
+    case LAWN2_QUANT_KERNEL: {
+        unsigned len = bitlen(ttl);
+        if (len <= LVL_BITS) return ttl;        /* level 0: exact */
+        unsigned level = (len - LVL_BITS + LVL_CLK_SHIFT - 1) / LVL_CLK_SHIFT;
+        if (level > LVL_DEPTH - 1) level = LVL_DEPTH - 1;  /* the catch-all level */
+        return round_up_pow2(ttl, level * LVL_CLK_SHIFT);
+    }
+    case LAWN2_QUANT_RELATIVE: {
+        unsigned len = bitlen(ttl);
+        return len <= param ? ttl : round_up_pow2(ttl, len - (unsigned)param);
+    }
+    case LAWN2_QUANT_FIXED:
+        if (param <= 1 || ttl % param == 0 || ttl > UINT64_MAX - param) return ttl;
+        return ttl + param - ttl % param;
+    default:
+        return ttl;
     }
-    l->count = new_count;
-    free(ot);
+}
+
+uint64_t lawn2_quantize(unsigned policy, uint64_t param, uint64_t ttl) {
+    return quantize(policy, policy == LAWN2_QUANT_RELATIVE ? quant_bits(param) : param, ttl);
+}
+
+/* The store's policy applied to a pushed ttl, with its error accounted. */
+static inline uint64_t quant_ttl(lawn2 *l, uint64_t ttl) {
+    if (!l->quant) return ttl;
+    uint64_t q = quantize(l->quant, l->quant_param, ttl);
+    if (q != ttl) {
+        uint64_t err = q - ttl, ppm = (uint64_t)((double)err * 1e6 / (double)ttl);
+        l->quant_rounded++;
+        l->quant_err_sum += err;
+        if (err > l->quant_err_max) l->quant_err_max = err;
+        if (ppm > l->quant_ppm_max) l->quant_ppm_max = ppm;
+    }
+    return q;
 }
 
 // ######################## user facing APIs ###########################
 
 
 lawn2 *lawn2_new(void) {
+    return lawn2_new_config(NULL);
+}
+
+lawn2 *lawn2_new_config(const lawn2_config *cfg) {
     lawn2 *l = calloc(1, sizeof *l);
-    l->bits = 4;
+    l->bits = l->min_bits = 4;
     l->cap = (size_t)1 << l->bits;
-    l->tab = calloc(l->cap, sizeof(blade));
+    l->tab = calloc(l->cap, sizeof(slot));
+    l->blades_cap = 16;
+    l->blades = malloc(l->blades_cap * sizeof *l->blades);
+    l->free_blade = l->idle_head = l->idle_tail = BLADE_NIL;
     l->next_expiration = UINT64_MAX;
+    if (cfg) {
+        l->flags = cfg->flags;
+        l->idle_ticks = cfg->idle_ticks;
+        l->disorder = cfg->disorder;
+        l->quant = cfg->quant;
+        l->quant_param = cfg->quant == LAWN2_QUANT_RELATIVE ? quant_bits(cfg->quant_param) : cfg->quant_param;
+        if (!(l->flags & LAWN2_INDEXED)) l->cold_max = cfg->cold_max;  /* indexed: every blade is in the heap */
+        l->direct_max = cfg->direct_max;
+    }
+    if (l->direct_max) {
+        l->direct = malloc(l->direct_max * sizeof *l->direct);
+        memset(l->direct, 0xff, l->direct_max * sizeof *l->direct);   /* BLADE_NIL */
+    }
+    if ((l->flags & LAWN2_INDEXED) || l->cold_max)
+        l->heap = malloc(l->blades_cap * sizeof *l->heap);
+    if (!(l->flags & LAWN2_INDEXED)) {
+        l->live_exp = malloc(l->blades_cap * sizeof *l->live_exp);
+        l->live_blade = malloc(l->blades_cap * sizeof *l->live_blade);
+    }
+#ifdef LAWN2_HAVE_AVX2
+    l->simd = !(l->flags & LAWN2_NO_SIMD) && __builtin_cpu_supports("avx2");
+#endif
     return l;
 }
 
 void lawn2_free(lawn2 *l) {
     if (!l) return;
+    free(l->heap);
+    free(l->merge);
+    free(l->ix);
+    free(l->rearmed);
+    free(l->live_exp);
+    free(l->live_blade);
+    free(l->blades);
+    free(l->otab);
     free(l->tab);
+    free(l->direct);
     free(l);
 }
 
-void lawn2_add(lawn2 *l, lawn2_timer *n, uint64_t ttl) {
-    if ((l->count + 1) * 10 >= l->cap * 7) grow(l);  /* keep load < 0.7 */
-    blade *b = find_slot(l, ttl);
-    int was_empty = !b->head;
-    if (!b->used) {
-        b->used = 1;
-        b->ttl = ttl;
-        b->head = b->tail = NULL;
-        l->count++;
+// ##################### lazy extension ################################
+/* lawn2_extend only rewrites a non-head node's expiration and flags it
+ * LAWN2_TIMER_STALE: its queue position still reflects the old deadline,
+ * which is earlier, so the blade's head (the only expiration anything
+ * reads) remains a valid lower bound for every node behind it. The cost is
+ * paid only if a stale node becomes a head: settle() then re-queues it at
+ * its real deadline - its own tail when that keeps the blade sorted, else
+ * the blade of its remaining time, still as a timer of its own TTL
+ * (requeue(); via l->deferred and flush_deferred(), so no blade is created
+ * or moved while a Poll is walking them). */
+
+/* Clear n's stale flag and put it where its real expiration belongs: if it
+ * is already due, in front of the first settled node that expires later
+ * (stale nodes in between are settled when they reach the head); else b's
+ * tail if it sorts there and no later push (at now + ttl) can sort before
+ * it, else the blade of its remaining time. */
+static void unstale(lawn2 *l, blade *b, lawn2_timer *n) {
+    n->flags &= ~LAWN2_TIMER_STALE;
+    b->nstale--;
+    uint64_t exp = exp_of(b, n);
+    if (exp <= l->now) {
+        lawn2_timer *at = n->next;
+        while (at && ((at->flags & LAWN2_TIMER_STALE) || exp_of(b, at) <= exp)) at = at->next;
+        if (at == n->next) return;              /* already in order */
+        if (n->prev) n->prev->next = n->next; else b->head = n->next;
+        n->next->prev = n->prev;
+        n->next = at;
+        if (at) {
+            n->prev = at->prev;
+            at->prev->next = n;
+            at->prev = n;
+        } else {
+            n->prev = b->tail;
+            b->tail->next = n;
+            b->tail = n;
+        }
+        return;
+    }
+    int fits = exp <= l->now + b->ttl;
+    if (n == b->tail && fits) return;
+    if (n->prev) n->prev->next = n->next; else b->head = n->next;
+    if (n->next) n->next->prev = n->prev; else b->tail = n->prev;
+    if (fits && exp >= exp_of(b, b->tail)) {
+        n->prev = b->tail;
+        n->next = NULL;
+        b->tail->next = n;
+        b->tail = n;
+    } else {
+        b->len--;
+        l->live--;                              /* lawn2_add counts it back */
+        leave(b, n);
+        n->next = l->deferred;
+        l->deferred = n;
     }
+}
+
+static void settle(lawn2 *l, blade *b) {
+    while (b->head && (b->head->flags & LAWN2_TIMER_STALE)) unstale(l, b, b->head);
+}
+
+/* Queue n (out of the store) in the blade of delay, but keep its own TTL
+ * class ttl in n->ttl for lawn2_touch to refresh by: a deadline is not a
+ * class, and taking it as one would leave a blade behind per delay. */
+static void requeue(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t delay) {
+    uint16_t grouped = n->flags & LAWN2_TIMER_GROUPED;  /* lawn2_add clears flags */
+    lawn2_add(l, n, delay);
+    n->flags |= grouped;
+    if (n->ttl == ttl) return;
     n->ttl = ttl;
-    n->expiration = l->now + ttl;
-    n->in_store = 1;
+    n->flags |= LAWN2_TIMER_AWAY;
+}
+
+static void flush_deferred(lawn2 *l) {
+    while (l->deferred) {
+        lawn2_timer *n = l->deferred;
+        l->deferred = n->next;
+        requeue(l, n, n->ttl, n->expiration - l->now);  /* leave() restored n->ttl */
+    }
+}
+
+/* b's head expiration moved (or b emptied): resync its hot entry. */
+static void head_moved(lawn2 *l, uint32_t bi) {
+    blade *b = &l->blades[bi];
+    if (!b->head) {
+        if (heaped(l, b)) heap_update(l, b);
+        else live_unlink(l, b);
+        idle_push(l, bi);
+    } else if (heaped(l, b)) {
+        heap_rekey(l, b);
+    } else {
+        l->live_exp[b->pos] = exp_of(b, b->head);
+        if (l->live_exp[b->pos] < l->next_expiration) l->next_expiration = l->live_exp[b->pos];
+    }
+}
+
+/* Append the pre-linked chain first..last (count nodes, all expiring no
+ * earlier than b's tail) to blade bi: the only step that touches the blade. */
+static void splice(lawn2 *l, uint32_t bi, lawn2_timer *first, lawn2_timer *last, uint64_t count) {
+    blade *b = &l->blades[bi];
+    int was_empty = !b->head;
+    if (was_empty) idle_unlink(l, b);
     /* append at tail; head stays the earliest */
+    first->prev = b->tail;
+    if (b->tail) b->tail->next = first; else b->head = first;
+    b->tail = last;
+    b->len += count;
+    l->live += count;
+    if (heaped(l, b)) {
+        if (was_empty) heap_push(l, bi);       /* tail append never moves a head */
+        promote_if_full(l, bi);
+        return;
+    }
+    if (exp_of(b, first) < l->next_expiration) l->next_expiration = exp_of(b, first);
+    if (was_empty) live_link(l, bi);
+}
+
+/* Queue n at blade bi's tail, due in that blade's TTL. */
+static void push(lawn2 *l, lawn2_timer *n, uint32_t bi) {
+    blade *b = &l->blades[bi];
+    n->ttl = b->ttl;
+    n->expiration = l->now + b->ttl - b->off;
+    n->in_store = 1;
+    n->flags = 0;
+    n->blade = bi;
     n->next = NULL;
-    n->prev = b->tail;
-    if (b->tail) b->tail->next = n; else b->head = n;
-    b->tail = n;
+    splice(l, bi, n, n, 1);
+}
+
+void lawn2_add(lawn2 *l, lawn2_timer *n, uint64_t ttl) {
+    push(l, n, blade_for(l, quant_ttl(l, ttl)));
+}
+
+/* The smallest live TTL in [ttl, ttl + slack] wins: the least lateness that
+ * adds no blade to the Poll. Failing that, the smallest drained one, which
+ * at least adds no TTL to the table. */
+void lawn2_add_slack(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t slack) {
+    if (!slack) {
+        lawn2_add(l, n, ttl);
+        return;
+    }
+    if (!l->ix) ix_build(l);
+    uint64_t hi = ttl > UINT64_MAX - slack ? UINT64_MAX : ttl + slack;
+    uint32_t bi = BLADE_NIL;
+    for (uint32_t i = ix_lower(l, ttl); i < l->nix && l->ix[i].key <= hi; i++) {
+        uint32_t c = l->ix[i].blade;
+        if (l->blades[c].head) {
+            bi = c;
+            break;
+        }
+        if (bi == BLADE_NIL) bi = c;
+    }
+    l->slack_adds++;
+    if (bi == BLADE_NIL) {                      /* nothing fits: a blade of its own */
+        lawn2_add(l, n, ttl);
+        return;
+    }
+    uint64_t late = l->blades[bi].ttl - ttl;
+    if (late) {
+        l->slack_coalesced++;
+        l->slack_late_sum += late;
+        if (late > l->slack_late_max) l->slack_late_max = late;
+    }
+    push(l, n, bi);
+}
+
+void lawn2_add_periodic(lawn2 *l, lawn2_timer *n, uint64_t interval) {
+    if (!interval) interval = 1;                /* a 0 period would re-fire forever */
+    lawn2_add(l, n, interval);
+    n->flags |= LAWN2_TIMER_PERIODIC;
+    l->blades[n->blade].nperiodic++;
+}
+
+void lawn2_group_join(lawn2_group *grp, lawn2_gtimer *g) {
+    if (!g->t.in_store) return;
+    lawn2_group_unlink(&g->t);
+    g->gprev = NULL;
+    g->gnext = grp->head;
+    if (grp->head) grp->head->gprev = g;
+    grp->head = g;
+    grp->count++;
+    g->group = grp;
+    g->t.flags |= LAWN2_TIMER_GROUPED;
+}
+
+void lawn2_add_grouped(lawn2 *l, lawn2_gtimer *g, uint64_t ttl, lawn2_group *grp) {
+    lawn2_add(l, &g->t, ttl);
+    lawn2_group_join(grp, g);
+}
+
+uint64_t lawn2_del_group(lawn2 *l, lawn2_group *grp) {
+    uint64_t k = grp->count;
+    while (grp->head) lawn2_del(l, &grp->head->t);  /* unlinks it from grp */
+    return k;
+}
+
+void lawn2_add_at(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t arrival) {
+    if (arrival >= l->now) {
+        lawn2_add(l, n, ttl);
+        return;
+    }
+    if (l->now - arrival > l->disorder) arrival = l->now - l->disorder;  /* fire late, never early */
+    ttl = quant_ttl(l, ttl);
+    uint32_t bi = blade_for(l, ttl);
+    blade *b = &l->blades[bi];
+    uint64_t exp = arrival + ttl;
+    n->ttl = ttl;
+    n->expiration = exp - b->off;
+    n->in_store = 1;
+    n->flags = 0;
+    n->blade = bi;
+    if (!b->head || exp >= exp_of(b, b->tail)) {
+        n->next = NULL;
+        splice(l, bi, n, n, 1);
+        return;
+    }
+    /* Only timers pushed since `arrival` can expire after n, so the scan
+     * back from the tail is bounded by what the last `disorder` ticks added.
+     * Comparing real expirations keeps stale nodes valid: each is queued no
+     * later than its real deadline. */
+    lawn2_timer *q = NULL;
+    if (exp >= exp_of(b, b->head))
+        for (q = b->tail; exp_of(b, q) > exp; q = q->prev) {}
+    n->prev = q;
+    n->next = q ? q->next : b->head;
+    n->next->prev = n;
+    if (q) q->next = n; else b->head = n;
+    b->len++;
     l->live++;
-    if (n->expiration < l->next_expiration) l->next_expiration = n->expiration;
-    if (was_empty) live_link(l, b);
+    if (!q) head_moved(l, bi);
+    promote_if_full(l, bi);
+}
+
+/* One pending chain per distinct TTL seen in a lawn2_add_batch call. */
+typedef struct batch_group {
+    uint64_t     ttl;
+    uint64_t     exp;                           /* stored expiration: now + ttl - off */
+    uint32_t     blade;
+    lawn2_timer *first, *last;
+    uint64_t     count;
+} batch_group;
+
+/* Ingest batches carry a few distinct TTLs. Past this many, the groups so
+ * far are spliced and the rest of the batch goes through lawn2_add. */
+#define BATCH_GROUPS 16
+#define BATCH_HASH_BITS 6                       /* TTL -> group, direct mapped */
+
+static void splice_groups(lawn2 *l, batch_group *g, uint32_t ng) {
+    for (uint32_t k = 0; k < ng; k++) splice(l, g[k].blade, g[k].first, g[k].last, g[k].count);
+}
+
+void lawn2_add_batch(lawn2 *l, lawn2_timer **nodes, const uint64_t *ttls, size_t n) {
+    batch_group g[BATCH_GROUPS];
+    uint8_t hint[1u << BATCH_HASH_BITS] = { 0 };  /* group + 1, 0: none */
+    uint32_t ng = 0, k = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t ttl = quant_ttl(l, ttls[i]);
+        if (k >= ng || g[k].ttl != ttl) {       /* runs of one TTL skip the lookup */
+            uint32_t h = (uint32_t)((ttl * GOLDEN) >> (64 - BATCH_HASH_BITS));
+            k = hint[h] - 1u;
+            if (!hint[h] || g[k].ttl != ttl)
+                for (k = 0; k < ng && g[k].ttl != ttl; k++) {}
+            if (k == ng) {
+                if (ng == BATCH_GROUPS) {       /* too many TTLs to be worth it */
+                    splice_groups(l, g, ng);
+                    lawn2_add(l, nodes[i], ttl);   /* already rounded: a no-op twice */
+                    for (i++; i < n; i++) lawn2_add(l, nodes[i], ttls[i]);
+                    return;
+                }
+                uint32_t bi = blade_for(l, ttl);
+                g[ng++] = (batch_group){ ttl, l->now + ttl - l->blades[bi].off, bi, NULL, NULL, 0 };
+                if (!hint[h]) hint[h] = (uint8_t)ng;
+            }
+        }
+        lawn2_timer *x = nodes[i];
+        x->ttl = ttl;
+        x->expiration = g[k].exp;
+        x->in_store = 1;
+        x->flags = 0;
+        x->blade = g[k].blade;
+        x->next = NULL;
+        x->prev = g[k].last;
+        if (g[k].last) g[k].last->next = x; else g[k].first = x;
+        g[k].last = x;
+        g[k].count++;
+    }
+    splice_groups(l, g, ng);
 }
 
 void lawn2_del(lawn2 *l, lawn2_timer *n) {
     if (!n->in_store) return;
-    blade *b = find_slot(l, n->ttl);            /* exists */
+    blade *b = &l->blades[n->blade];            /* no hash, no probe */
+    int was_head = !n->prev;
     if (n->prev) n->prev->next = n->next; else b->head = n->next;
     if (n->next) n->next->prev = n->prev; else b->tail = n->prev;
     n->next = n->prev = NULL;
     n->in_store = 0;
+    lawn2_group_unlink(n);
+    leave(b, n);
+    b->len--;
+    if (n->flags & LAWN2_TIMER_PERIODIC) b->nperiodic--;
+    if (n->flags & LAWN2_TIMER_STALE) b->nstale--;
     l->live--;
-    if (!b->head) live_unlink(l, b);
+    if (was_head) settle(l, b);
+    if (!b->head) idle_push(l, n->blade);
+    if (heaped(l, b)) {
+        if (was_head) heap_update(l, b);        /* keeps next_expiration exact */
+    } else if (!b->head) {
+        live_unlink(l, b);
+    } else if (was_head) {
+        l->live_exp[b->pos] = exp_of(b, b->head);
+    }
     /* next_expiration stays a valid lower bound (removal only delays expiry). and this will update on the next tick either way */
+    flush_deferred(l);
+}
+
+/* A batch cancel touches each node and its two neighbours (all cold) and
+ * then, per blade whose head it removed, the hot entry. The nodes are
+ * prefetched DEL_AHEAD * 2 ahead and their neighbours and blade DEL_AHEAD
+ * ahead (by then the node itself is in cache); the per-blade resync is
+ * deferred to del_fixup() and next_expiration to one pass at the end. */
+#define DEL_AHEAD 8
+#define DEL_DIRTY 64
+
+/* bi lost its head to a batch unlink: settle it and resync its hot entry or
+ * heap slot. Idempotent, so a blade listed twice costs only a re-check. */
+static void del_fixup(lawn2 *l, uint32_t bi) {
+    blade *b = &l->blades[bi];
+    settle(l, b);
+    if (heaped(l, b)) {
+        if (b->pos >= l->hlen || l->heap[b->pos].blade != bi) return;  /* dropped already */
+        heap_update(l, b);
+    } else {
+        if (b->pos >= l->nlive || l->live_blade[b->pos] != bi) return;
+        if (b->head) {
+            l->live_exp[b->pos] = exp_of(b, b->head);
+            return;
+        }
+        live_unlink(l, b);
+    }
+    if (!b->head) idle_push(l, bi);
+}
+
+void lawn2_del_batch(lawn2 *l, lawn2_timer **nodes, size_t n) {
+    uint32_t dirty[DEL_DIRTY], ndirty = 0;
+    int rescan = 0;                             /* a head at next_expiration left */
+    for (size_t i = 0; i < n; i++) {
+        if (i + 2 * DEL_AHEAD < n) PREFETCH(nodes[i + 2 * DEL_AHEAD]);
+        if (i + DEL_AHEAD < n) {
+            lawn2_timer *y = nodes[i + DEL_AHEAD];
+            PREFETCH(y->prev);
+            PREFETCH(y->next);
+            PREFETCH(&l->blades[y->blade]);
+        }
+        lawn2_timer *x = nodes[i];
+        if (!x->in_store) continue;
+        blade *b = &l->blades[x->blade];
+        if (x->prev) x->prev->next = x->next; else b->head = x->next;
+        if (x->next) x->next->prev = x->prev; else b->tail = x->prev;
+        b->len--;
+        if (x->flags & LAWN2_TIMER_PERIODIC) b->nperiodic--;
+        if (x->flags & LAWN2_TIMER_STALE) b->nstale--;
+        l->live--;
+        if (!x->prev) {
+            if (!heaped(l, b) && l->live_exp[b->pos] <= l->next_expiration) rescan = 1;
+            if (ndirty == DEL_DIRTY) {
+                for (uint32_t k = 0; k < ndirty; k++) del_fixup(l, dirty[k]);
+                flush_deferred(l);              /* a later node may be a deferred one */
+                ndirty = 0;
+            }
+            dirty[ndirty++] = x->blade;
+        }
+        x->next = x->prev = NULL;
+        x->in_store = 0;
+        lawn2_group_unlink(x);
+        leave(b, x);
+    }
+    for (uint32_t k = 0; k < ndirty; k++) del_fixup(l, dirty[k]);
+    flush_deferred(l);
+    if (rescan && !l->pending) l->next_expiration = next_bound(l);  /* exact again */
+}
+
+/* lawn2_del + lawn2_add, keeping n's group: a move, not a cancel. */
+static void move(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t delay) {
+    lawn2_group *grp = (n->flags & LAWN2_TIMER_GROUPED) ? ((lawn2_gtimer *)n)->group : NULL;
+    lawn2_del(l, n);
+    requeue(l, n, ttl, delay);
+    if (grp) lawn2_group_join(grp, (lawn2_gtimer *)n);
+}
+
+void lawn2_touch(lawn2 *l, lawn2_timer *n) {
+    if (!n->in_store) return;
+    if (n->flags & LAWN2_TIMER_AWAY) {          /* back to its own TTL's blade */
+        move(l, n, n->ttl, n->ttl);
+        return;
+    }
+    blade *b = &l->blades[n->blade];            /* no hash, no probe */
+    int was_head = !n->prev;
+    n->expiration = l->now + b->ttl - b->off;   /* >= every expiry in b: tail */
+    if (n->flags & LAWN2_TIMER_STALE) {
+        n->flags &= ~LAWN2_TIMER_STALE;
+        b->nstale--;
+    }
+    if (b->tail != n) {
+        if (n->prev) n->prev->next = n->next; else b->head = n->next;
+        n->next->prev = n->prev;
+        n->prev = b->tail;
+        n->next = NULL;
+        b->tail->next = n;
+        b->tail = n;
+    }
+    if (!was_head) return;
+    settle(l, b);
+    /* the head moved later: a lower bound stays valid, as after lawn2_del */
+    if (heaped(l, b)) heap_update(l, b);
+    else l->live_exp[b->pos] = exp_of(b, b->head);
+    flush_deferred(l);
+}
+
+void lawn2_extend(lawn2 *l, lawn2_timer *n, uint64_t delay) {
+    if (!n->in_store || (n->flags & LAWN2_TIMER_PERIODIC)) return;
+    uint64_t exp = l->now + delay;
+    uint32_t bi = n->blade;
+    blade *b = &l->blades[bi];
+    if (exp == exp_of(b, n)) return;
+    int fits = exp <= l->now + b->ttl;          /* no later push can sort before it */
+    /* earlier, or alone and would leave b empty: not lazy, re-queue now */
+    if (exp < exp_of(b, n) || (b->tail == n && !n->prev && !fits)) {
+        move(l, n, (n->flags & LAWN2_TIMER_AWAY) ? n->ttl : b->ttl, delay);
+        return;
+    }
+    n->expiration = exp - b->off;
+    if (b->tail == n && n->prev && fits) return;  /* still sorted */
+    if (!(n->flags & LAWN2_TIMER_STALE)) {
+        n->flags |= LAWN2_TIMER_STALE;
+        b->nstale++;
+    }
+    if (n->prev) return;                        /* lazy: nothing else is touched */
+    settle(l, b);                               /* the head must not stay stale */
+    head_moved(l, bi);                          /* settle() may have emptied b */
+    flush_deferred(l);
+}
+
+// ##################### per-TTL operations ############################
+/* A blade holds exactly one TTL class, so whole-class operations work on
+ * the blade rather than its timers: detaching is a list cut, and retiming
+ * moves the blade's expiration offset (exp_of()) and its table key. */
+
+uint64_t lawn2_detach_ttl(lawn2 *l, uint64_t ttl, lawn2_segment *out) {
+    ttl = quantize(l->quant, l->quant_param, ttl);
+    uint32_t bi = blade_find(l, ttl);
+    blade *b = bi == BLADE_NIL ? NULL : &l->blades[bi];
+    *out = (lawn2_segment){ ttl, NULL, NULL, 0, 0 };
+    if (!b || !b->head) return 0;
+    *out = (lawn2_segment){ ttl, b->head, b->tail, b->len, b->off };
+    l->live -= b->len;
+    b->head = b->tail = NULL;
+    b->len = b->nperiodic = b->nstale = 0;
+    head_moved(l, bi);
+    return out->count;
+}
+
+/* Pull b's stale nodes out for re-queueing (via l->deferred), so the rest
+ * is sorted by real expiration. Those of b's own class leave as class ttl. */
+static void unstale_all(lawn2 *l, blade *b, uint64_t ttl) {
+    for (lawn2_timer *x = b->head, *nx; b->nstale && x; x = nx) {
+        nx = x->next;
+        if (!(x->flags & LAWN2_TIMER_STALE)) continue;
+        x->flags &= ~LAWN2_TIMER_STALE;
+        b->nstale--;
+        if (x->prev) x->prev->next = x->next; else b->head = x->next;
+        if (x->next) x->next->prev = x->prev; else b->tail = x->prev;
+        b->len--;
+        l->live--;                              /* lawn2_add counts it back */
+        int own = !(x->flags & LAWN2_TIMER_AWAY);
+        leave(b, x);
+        if (own) x->ttl = ttl;
+        x->next = l->deferred;
+        l->deferred = x;
+    }
+}
+
+/* Retime onto a TTL that already has timers: merge a into t, O(a + t). */
+static void merge_into(lawn2 *l, uint32_t ai, uint32_t ti) {
+    blade *a = &l->blades[ai], *t = &l->blades[ti];
+    unstale_all(l, a, t->ttl);                  /* a's class is t's from now on */
+    unstale_all(l, t, t->ttl);
+    lawn2_timer *pa = a->head, *pt = t->head, *tail = NULL;
+    t->head = NULL;
+    while (pa || pt) {
+        lawn2_timer *x;
+        if (pt && (!pa || exp_of(t, pt) <= exp_of(a, pa))) {
+            x = pt;
+            pt = pt->next;
+        } else {
+            x = pa;
+            pa = pa->next;
+            x->expiration = exp_of(a, x) - t->off;
+            x->blade = ti;
+        }
+        x->prev = tail;
+        if (tail) tail->next = x; else t->head = x;
+        tail = x;
+    }
+    tail->next = NULL;
+    t->tail = tail;
+    t->len += a->len;
+    t->nperiodic += a->nperiodic;
+    a->head = a->tail = NULL;
+    a->len = a->nperiodic = 0;
+    head_moved(l, ai);
+    head_moved(l, ti);
+    promote_if_full(l, ti);
 }
 
-/* Shared by lawn2_tick/lawn2_advance: fire everything due by `now` (which the
- * caller has already stored into l->now). Walks only non-empty buckets via
- * live_head, unlinking any that drain to empty as it goes. */
-static uint64_t collect_expired(lawn2 *l, uint64_t now, lawn2_timer **out_head) {
-    if (out_head) *out_head = NULL;
+uint64_t lawn2_retime_ttl(lawn2 *l, uint64_t ttl, uint64_t new_ttl) {
+    ttl = quantize(l->quant, l->quant_param, ttl);
+    new_ttl = quantize(l->quant, l->quant_param, new_ttl);
+    uint32_t bi = blade_find(l, ttl);
+    if (bi == BLADE_NIL || !l->blades[bi].head || ttl == new_ttl) return 0;
+    l->blades[bi].off += new_ttl - ttl;         /* every deadline moves with the class */
+    uint64_t moved = l->blades[bi].len;
+    uint32_t ti = blade_find(l, new_ttl);
+    if (ti != BLADE_NIL && l->blades[ti].head) {
+        merge_into(l, bi, ti);
+        flush_deferred(l);
+        return moved;
+    }
+    /* O(1): the blade itself becomes new_ttl's */
+    if (ti != BLADE_NIL) {                      /* new_ttl's drained blade gives way */
+        blade *t = &l->blades[ti];
+        idle_unlink(l, t);
+        if (new_ttl < l->direct_max) {
+            l->direct[new_ttl] = bi;
+        } else {
+            slot *e = probe(l->tab, l->bits, new_ttl);
+            if (e->state != SLOT_USED) e = probe(l->otab, l->obits, new_ttl);
+            e->blade = bi;
+        }
+        t->idle_next = l->free_blade;
+        l->free_blade = ti;
+    } else if (new_ttl < l->direct_max) {
+        l->direct[new_ttl] = bi;
+        l->ndirect++;
+    } else {
+        if (((size_t)l->nused + l->ntomb + 1) * 10 >= l->cap * 7)
+            rehash(l, ((size_t)l->nused + 1) * 20 >= l->cap * 7 ? l->bits + 1 : l->bits);
+        slot *e = probe(l->tab, l->bits, new_ttl);
+        if (e->state == SLOT_TOMB) l->ntomb--;
+        *e = (slot){ new_ttl, bi, SLOT_USED };
+        l->nused++;
+    }
+    ix_set(l, new_ttl, bi);
+    slot_drop(l, ttl);
+    l->blades[bi].ttl = new_ttl;
+    head_moved(l, bi);
+    return moved;
+}
+
+uint64_t lawn2_expiration(lawn2 *l, const lawn2_timer *n) {
+    return n->in_store ? exp_of(&l->blades[n->blade], n) : n->expiration;
+}
+
+/* n (due, in b) is periodic: instead of firing it out of the store, move it
+ * to b's tail due again in one ttl, exactly like a re-add at l->now but with
+ * no table lookup. Same TTL, later expiry, so the blade stays sorted. The
+ * caller still counts it as fired (and so subtracts it from l->live: add it
+ * back here); collect() takes it back out of the Poll's return value, and it
+ * is reported through lawn2_rearmed(). */
+static void rearm(lawn2 *l, blade *b, lawn2_timer *n) {
+    n->expiration = l->now + b->ttl - b->off;
+    if (b->tail != n) {
+        if (n->prev) n->prev->next = n->next; else b->head = n->next;
+        n->next->prev = n->prev;
+        n->prev = b->tail;
+        n->next = NULL;
+        b->tail->next = n;
+        b->tail = n;
+    }
+    l->live++;
+    if (l->nrearmed == l->rearmed_cap) {
+        l->rearmed_cap = l->rearmed_cap ? l->rearmed_cap * 2 : 64;
+        l->rearmed = realloc(l->rearmed, l->rearmed_cap * sizeof *l->rearmed);
+    }
+    l->rearmed[l->nrearmed++] = n;
+}
+
+/* Where a Poll puts what it fires: a LIFO node list or (buf != NULL) a
+ * caller array, capped at `max` timers, or (segs != NULL) one segment per
+ * due blade, capped at max_segs. */
+typedef struct sink {
+    lawn2_timer  **out_head;
+    uint64_t       max;
+    lawn2_timer  **buf;      /* lawn2_advance_into: max == its free capacity */
+    size_t         nbuf;
+    lawn2_segment *segs;
+    size_t         nsegs, max_segs;
+    int            ordered;  /* lawn2_advance_ordered: append in expiry order */
+    lawn2_timer  **link;     /* ordered: where the next fired node goes */
+} sink;
+
+static int sink_full(const sink *o) {
+    return o->segs ? o->nsegs == o->max_segs : o->max == 0;
+}
+
+/* Pop up to o->max of b's due prefix (head expiration <= now) onto the list,
+ * or into the array in expiry order. */
+static uint64_t expire_list(lawn2 *l, blade *b, uint64_t now, sink *o) {
+    uint64_t fired = 0, rearmed = 0;
+    while (fired < o->max && b->head && exp_of(b, b->head) <= now) {  /* self-sorted head */
+        lawn2_timer *n = b->head;
+        if (n->flags & LAWN2_TIMER_PERIODIC) {
+            rearm(l, b, n);
+            settle(l, b);
+            fired++;
+            rearmed++;
+            continue;
+        }
+        b->head = n->next; /* Unlink from blade */
+        if (b->head) b->head->prev = NULL; else b->tail = NULL;
+        n->next = n->prev = NULL;
+        n->in_store = 0;
+        lawn2_group_unlink(n);
+        leave(b, n);
+        settle(l, b);
+
+        /* Push onto output singly-linked list */
+        if (o->buf) {
+            o->buf[o->nbuf++] = n;
+        } else if (o->out_head) {
+            n->next = *o->out_head;
+            n->prev = NULL;
+            *o->out_head = n;
+        } else {
+            n->next = n->prev = NULL;
+        }
+
+        fired++;
+    }
+    o->max -= fired;
+    b->len -= fired - rearmed;
+    return fired;
+}
+
+/* Cut b's due prefix off as one segment: a fully due blade (tail due) goes
+ * whole in O(1), otherwise the prefix end is found by a read-only walk. A
+ * handful of pointer writes either way; the nodes are left as they are
+ * (in_store included) for lawn2_seg_pop() to finish in the caller's pass. */
+static uint64_t expire_segment(lawn2 *l, blade *b, uint64_t now, sink *o) {
+    uint64_t rearmed = 0;
+    if (b->nperiodic || b->nstale) {
+        /* re-arm the periodic ones and re-queue stale ones that are not
+         * really due yet first; the one-shot rest stays a chain */
+        for (lawn2_timer *x = b->head, *nx; x && ((x->flags & LAWN2_TIMER_STALE) || exp_of(b, x) <= now); x = nx) {
+            nx = x->next;
+            if (x->flags & LAWN2_TIMER_PERIODIC) {
+                rearm(l, b, x);
+                rearmed++;
+            } else if (x->flags & LAWN2_TIMER_STALE) {
+                unstale(l, b, x);
+            }
+        }
+        if (!b->head || exp_of(b, b->head) > now) return rearmed;
+    }
+    lawn2_segment *sg = &o->segs[o->nsegs++];
+    sg->ttl = b->ttl;
+    sg->exp_off = b->off;
+    sg->first = b->head;
+    if (exp_of(b, b->tail) <= now) {
+        sg->last = b->tail;
+        sg->count = b->len;
+        b->head = b->tail = NULL;
+    } else {
+        lawn2_timer *x = b->head;
+        uint64_t c = 0;
+        for (; exp_of(b, x) <= now; x = x->next) c++;
+        sg->last = x->prev;
+        sg->count = c;
+        sg->last->next = NULL;
+        x->prev = NULL;
+        b->head = x;
+    }
+    b->len -= sg->count;
+    return sg->count + rearmed;
+}
+
+static uint64_t expire_blade(lawn2 *l, blade *b, uint64_t now, sink *o) {
+    return o->segs ? expire_segment(l, b, now, o) : expire_list(l, b, now, o);
+}
+
+/* Shared by every Poll: fire timers due by `now` (which the caller has
+ * already stored into l->now) into sink o, starting the scan at hot slot
+ * `from`. Streams over the hot head array for due blades, only
+ * dereferencing those, and swap-removes any that drain to empty as it
+ * goes; under LAWN2_INDEXED it pops only the due blades off the heap
+ * instead, and hybrid mode does both, cold blades first. If the sink fills
+ * while a due blade remains, it sets l->pending and leaves the scan cursor
+ * in l->drain for the next call to resume from. */
+static uint64_t collect_expired(lawn2 *l, uint64_t now, uint32_t from, sink *o) {
+    if (o->out_head) *o->out_head = NULL;
+    o->nsegs = 0;
+    l->pending = 0;
     if (now < l->next_expiration) return 0;   /* O(1) empty advance */
 
     uint64_t fired = 0;
-    uint64_t ne = UINT64_MAX; /* recompute over t heads in flight */
-    blade *b = l->live_head;
-    while (b) {
-        blade *next_live = b->live_next;  /* save: b may leave the list below */
-
-        while (b->head && b->head->expiration <= now) {  /* self-sorted head */
-            lawn2_timer *n = b->head;
-            b->head = n->next; /* Unlink from blade */
-            if (b->head) b->head->prev = NULL; else b->tail = NULL;
-            n->next = n->prev = NULL;
-            n->in_store = 0;
-
-            /* Push onto output singly-linked list */
-            if (out_head) {
-                n->next = *out_head;
-                n->prev = NULL;
-                *out_head = n;
-            } else {
-                n->next = n->prev = NULL;
+    if ((l->flags & LAWN2_INDEXED) || l->cold_max) {
+        while (l->hlen && l->heap[0].key <= now) {
+            if (sink_full(o)) {
+                l->pending = 1;                /* the heap itself is the cursor */
+                break;
             }
+            uint32_t bi = l->heap[0].blade;
+            blade *b = &l->blades[bi];
+            fired += expire_blade(l, b, now, o);
+            heap_update(l, b);                 /* resyncs next_expiration */
+            if (!b->head) idle_push(l, bi);
+        }
+        if (l->flags & LAWN2_INDEXED) {
+            l->live -= fired;
+            return fired;
+        }
+        if (l->pending) {
+            l->drain = from;                   /* the hot arrays are untouched */
+            l->live -= fired;
+            l->next_expiration = now;
+            return fired;
+        }
+    }
 
+    uint32_t i = from;
+    while ((i = first_due(l, i, now)) < l->nlive) {
+        if (sink_full(o)) {
+            l->pending = 1;
+            l->drain = i;
+            l->live -= fired;
+            l->next_expiration = now;          /* blade i is still due */
+            return fired;
+        }
+        uint32_t bi = l->live_blade[i];
+        blade *b = &l->blades[bi];
+        fired += expire_blade(l, b, now, o);
+        if (!b->head) {
+            live_unlink(l, b);             /* the last blade moves into i: rescan it */
+            idle_push(l, bi);
+        } else {
+            l->live_exp[i] = exp_of(b, b->head);
+            if (l->live_exp[i] <= now) continue;  /* the budget cut it short */
+            if (b->len * 2 < l->cold_max) demote(l, bi);  /* as for a drain: rescan i */
+            else i++;
+        }
+    }
+    l->live -= fired;
+    l->next_expiration = next_bound(l);    /* second streaming pass over t heads */
+    return fired;
+}
+
+// ##################### expiry-ordered Poll ##########################
+/* A k-way merge of the due blade prefixes: each blade is already sorted, so
+ * a min-heap of due blades keyed by head expiration yields a globally
+ * ordered stream. The top blade fires its whole run up to the next blade's
+ * head (its heap children bound that) before a sift, so the cost is
+ * O(x + r log d) for r runs over d due blades, and O(x) when one TTL
+ * dominates. LAWN2_INDEXED merges straight off the blade heap; scan mode
+ * builds a scratch heap of the due blades per call. */
+
+/* Append b's prefix up to `limit` (<= now) to the ordered output. */
+static uint64_t expire_sorted(lawn2 *l, blade *b, uint64_t limit, sink *o) {
+    uint64_t fired = 0, rearmed = 0;
+    while (fired < o->max && b->head && exp_of(b, b->head) <= limit) {
+        lawn2_timer *n = b->head;
+        if (n->flags & LAWN2_TIMER_PERIODIC) {
+            rearm(l, b, n);
+            settle(l, b);
             fired++;
+            rearmed++;
+            continue;
+        }
+        b->head = n->next;
+        if (b->head) b->head->prev = NULL; else b->tail = NULL;
+        n->next = n->prev = NULL;
+        n->in_store = 0;
+        lawn2_group_unlink(n);
+        leave(b, n);
+        settle(l, b);
+        if (o->link) {
+            *o->link = n;
+            o->link = &n->next;
         }
-        if (!b->head) live_unlink(l, b);
-        else if (b->head->expiration < ne) ne = b->head->expiration;
-        b = next_live;
+        fired++;
+    }
+    o->max -= fired;
+    b->len -= fired - rearmed;
+    return fired;
+}
+
+/* Run limit for heap top blade: no later than now or either child's head. */
+static uint64_t run_limit(const heap_ent *h, uint32_t n, uint64_t now) {
+    uint64_t limit = now;
+    if (n > 1 && h[1].key < limit) limit = h[1].key;
+    if (n > 2 && h[2].key < limit) limit = h[2].key;
+    return limit;
+}
+
+static void merge_sift(heap_ent *h, uint32_t n, uint32_t i) {
+    heap_ent e = h[i];
+    for (;;) {
+        size_t c = 2 * (size_t)i + 1;
+        if (c >= n) break;
+        if (c + 1 < n && h[c + 1].key < h[c].key) c++;
+        if (e.key <= h[c].key) break;
+        h[i] = h[c];
+        i = (uint32_t)c;
+    }
+    h[i] = e;
+}
+
+/* Scan mode: b left the merge; sync its hot slot, or heap slot if cold. */
+static void merge_retire(lawn2 *l, blade *b, uint32_t bi) {
+    if (heaped(l, b)) {
+        heap_update(l, b);
+        if (!b->head) idle_push(l, bi);
+    } else if (!b->head) {
+        live_unlink(l, b);
+        idle_push(l, bi);
+    } else {
+        l->live_exp[b->pos] = exp_of(b, b->head);
+    }
+}
+
+/* Hybrid mode: add the due cold blades to the scratch merge heap m. The
+ * blade heap is only read here: due entries form a subtree at its root. */
+static uint32_t merge_cold(const lawn2 *l, uint64_t now, heap_ent *m, uint32_t mlen) {
+    if (!l->hlen || l->heap[0].key > now) return mlen;
+    uint32_t top = mlen;
+    m[mlen++] = l->heap[0];
+    for (uint32_t k = top; k < mlen; k++) {   /* breadth-first, m doubles as the queue */
+        size_t c = 2 * (size_t)l->blades[m[k].blade].pos + 1;
+        for (size_t d = c; d < c + 2 && d < l->hlen; d++)
+            if (l->heap[d].key <= now) m[mlen++] = l->heap[d];
     }
+    return mlen;
+}
+
+static uint64_t collect_ordered(lawn2 *l, uint64_t now, sink *o) {
+    if (o->out_head) *o->out_head = NULL;
+    o->link = o->out_head;
+    l->pending = 0;
+    if (now < l->next_expiration) return 0;   /* O(1) empty advance */
+
+    uint64_t fired = 0;
+    if (l->flags & LAWN2_INDEXED) {
+        while (l->hlen && l->heap[0].key <= now) {
+            if (!o->max) {
+                l->pending = 1;
+                break;
+            }
+            uint32_t bi = l->heap[0].blade;
+            blade *b = &l->blades[bi];
+            fired += expire_sorted(l, b, run_limit(l->heap, l->hlen, now), o);
+            heap_update(l, b);                 /* resyncs next_expiration */
+            if (!b->head) idle_push(l, bi);
+        }
+        l->live -= fired;
+        return fired;
+    }
+
+    if (!l->merge) l->merge = malloc(l->blades_cap * sizeof *l->merge);
+    heap_ent *m = l->merge;
+    uint32_t mlen = 0;
+    for (uint32_t i = 0; (i = first_due(l, i, now)) < l->nlive; i++)
+        m[mlen++] = (heap_ent){ l->live_exp[i], l->live_blade[i] };
+    if (l->cold_max) mlen = merge_cold(l, now, m, mlen);
+    for (uint32_t k = mlen / 2; k-- > 0;) merge_sift(m, mlen, k);
+    while (mlen) {
+        if (!o->max) {
+            l->pending = 1;
+            break;
+        }
+        uint32_t bi = m[0].blade;
+        blade *b = &l->blades[bi];
+        fired += expire_sorted(l, b, run_limit(m, mlen, now), o);
+        if (b->head && exp_of(b, b->head) <= now) {
+            m[0].key = exp_of(b, b->head);
+        } else {
+            m[0] = m[--mlen];
+            merge_retire(l, b, bi);
+        }
+        if (mlen) merge_sift(m, mlen, 0);
+    }
+    for (uint32_t k = 0; k < mlen; k++)        /* budget ran out: still due */
+        merge_retire(l, &l->blades[m[k].blade], m[k].blade);
     l->live -= fired;
-    l->next_expiration = ne;
+    if (l->pending) {
+        l->drain = 0;                          /* due blades can sit anywhere */
+        l->next_expiration = now;
+    } else {
+        l->next_expiration = next_bound(l);
+    }
     return fired;
 }
 
-uint64_t lawn2_tick(lawn2 *l, lawn2_timer **out_head) {
-    l->now++;
-    return collect_expired(l, l->now, out_head);
+// ##################### Poll entry points #############################
+
+/* Returns what o was handed: periodic timers re-armed on the way count
+ * against o->max but are reported through lawn2_rearmed() only. */
+static uint64_t collect(lawn2 *l, uint64_t now, uint32_t from, sink *o) {
+    uint64_t fired = o->ordered ? collect_ordered(l, now, o) : collect_expired(l, now, from, o);
+    flush_deferred(l);                          /* blades may move again now */
+    return fired - l->nrearmed;
 }
 
-uint64_t lawn2_advance(lawn2 *l, uint64_t target_now, lawn2_timer **out_head) {
+static uint64_t advance(lawn2 *l, uint64_t target_now, sink *o) {
+    l->nrearmed = 0;
     if (target_now <= l->now) {
-        if (out_head) *out_head = NULL;
+        if (l->pending) return collect(l, l->now, l->drain, o);
+        if (o->out_head) *o->out_head = NULL;
+        o->nsegs = 0;
         return 0;
     }
     l->now = target_now;
-    return collect_expired(l, target_now, out_head);
+    if (l->otab) migrate(l, MIGRATE_STEP);
+    if (l->idle_head != BLADE_NIL) reap_idle(l);
+    /* a new now can make blades behind the old cursor due again: full scan */
+    return collect(l, target_now, 0, o);
+}
+
+uint64_t lawn2_tick(lawn2 *l, lawn2_timer **out_head) {
+    return lawn2_advance_budget(l, l->now + 1, UINT64_MAX, out_head);
+}
+
+uint64_t lawn2_advance(lawn2 *l, uint64_t target_now, lawn2_timer **out_head) {
+    return lawn2_advance_budget(l, target_now, UINT64_MAX, out_head);
+}
+
+uint64_t lawn2_advance_budget(lawn2 *l, uint64_t target_now, uint64_t max_fire,
+                              lawn2_timer **out_head) {
+    sink o = { out_head, max_fire, NULL, 0, NULL, 0, 0, 0, NULL };
+    return advance(l, target_now, &o);
+}
+
+uint64_t lawn2_advance_ordered(lawn2 *l, uint64_t target_now, uint64_t max_fire,
+                               lawn2_timer **out_head) {
+    sink o = { out_head, max_fire, NULL, 0, NULL, 0, 0, 1, NULL };
+    return advance(l, target_now, &o);
+}
+
+uint64_t lawn2_advance_into(lawn2 *l, uint64_t target_now, lawn2_timer **buf,
+                            size_t cap, size_t *n) {
+    sink o = { NULL, cap, buf, 0, NULL, 0, 0, 0, NULL };
+    uint64_t fired = advance(l, target_now, &o);
+    *n = o.nbuf;
+    return fired;
+}
+
+uint64_t lawn2_advance_segments(lawn2 *l, uint64_t target_now, lawn2_segment *segs,
+                                size_t max_segs, size_t *nsegs) {
+    sink o = { NULL, 0, NULL, 0, segs, 0, max_segs, 0, NULL };
+    uint64_t fired = advance(l, target_now, &o);
+    *nsegs = o.nsegs;
+    return fired;
+}
+
+lawn2_timer **lawn2_rearmed(lawn2 *l, size_t *n) {
+    *n = l->nrearmed;
+    return l->rearmed;
+}
+
+int lawn2_pending(lawn2 *l) {
+    return l->pending;
 }
 
 uint64_t lawn2_size(lawn2 *l) { 
@@ -237,3 +1767,32 @@ uint64_t lawn2_next_expiration(lawn2 *l) {
 void lawn2_set_now(lawn2 *l, uint64_t now) {
     if (l) l->now = now;
 }
+
+void lawn2_reserve(lawn2 *l, uint64_t ttls) {
+    if (ttls > LAWN2_RESERVE_MAX) return;      /* no hint: growth stays incremental */
+    unsigned bits = l->bits;
+    while ((ttls + 1) * 10 >= ((uint64_t)1 << bits) * 7) bits++;
+    if (bits > l->bits) rehash(l, bits);
+    if (l->otab) migrate(l, SIZE_MAX);          /* startup call: pay it all now */
+    if (bits > l->min_bits) l->min_bits = bits;
+    uint64_t cap = l->blades_cap;
+    while (cap < ttls) cap *= 2;
+    if (cap != l->blades_cap) grow_blades(l, (uint32_t)cap);
+}
+
+void lawn2_get_stats(lawn2 *l, lawn2_stats *out) {
+    out->blades = l->nused + l->ndirect;
+    out->table_cap = l->cap;
+    out->reclaimed = l->reclaimed;
+    out->quant_rounded = l->quant_rounded;
+    out->quant_err_sum = l->quant_err_sum;
+    out->quant_err_max = l->quant_err_max;
+    out->quant_ppm_max = l->quant_ppm_max;
+    out->slack_adds = l->slack_adds;
+    out->slack_coalesced = l->slack_coalesced;
+    out->slack_late_sum = l->slack_late_sum;
+    out->slack_late_max = l->slack_late_max;
+    out->cold_blades = l->cold_max ? l->hlen : 0;
+    out->promoted = l->promoted;
+    out->demoted = l->demoted;
+}
@@ -4,13 +4,52 @@
  * of TTL -> self-sorted queue; Push O(1), Pull O(1), Poll O(max(x,t)). It only
  * changes the implementation to drop the per-insert tax of the original:
  *   - intrusive, caller-owned nodes  -> no per-insert node malloc, no key copy
- *   - O(1) handle delete via node links -> no element-id hashmap, no key hash
+ *   - O(1) handle delete via node links -> no element-id hashmap, no key hash,
+ *     and no TTL-table probe either (the node caches its blade's index)
  *   - open-addressing TTL->queue table -> no per-entry malloc (vs libbpf chain)
+ *   - cfg.direct_max (optional)        -> small dense TTLs index their blade
+ *     directly in a flat array: no hash, no probe
  *   - next_expiration lower bound      -> O(1) empty ticks (as in src/lawn.c)
- *   - live-bucket list                 -> Poll only visits non-empty buckets,
- *     not the whole table (Linux timer-wheel "pending" bitmap, adapted)
+ *   - dense live-head array            -> Poll streams (AVX2 where available)
+ *     over the head expirations of non-empty buckets only, not the whole
+ *     table (Linux timer-wheel "pending" bitmap, adapted)
  *   - lawn2_advance                    -> jump the clock forward in one call
  *     instead of looping lawn2_tick (Linux timer-wheel timeouts_update)
+ *   - LAWN2_INDEXED (optional)         -> min-heap of blade heads: Poll only
+ *     touches due blades, O(d log t), and next_expiration is exact
+ *   - cfg.cold_max (optional)          -> hybrid: blades with few timers sit
+ *     in an overflow heap, so a long tail of near-unique TTLs costs a Poll
+ *     nothing until due; popular TTLs are promoted to the scanned arrays
+ *   - cfg.idle_ticks (optional)        -> reclaim blades left empty that long
+ *     and shrink the TTL table, so drifting TTLs don't grow it forever
+ *   - lawn2_advance_segments           -> Poll hands back each blade's due
+ *     prefix as one cut-out segment: O(due blades) writes, expiry order kept
+ *   - lawn2_advance_ordered            -> k-way merge of due blade prefixes:
+ *     output in global expiration order
+ *   - lawn2_add_batch                  -> one TTL lookup and one tail
+ *     splice per distinct TTL in a batch of pushes
+ *   - lawn2_del_batch                  -> prefetched bulk cancel, one
+ *     resync per blade that lost its head
+ *   - lawn2_add_at + cfg.disorder      -> event-time pushes up to `disorder`
+ *     ticks late, slotted in by a bounded scan from the blade tail
+ *   - lawn2_touch                      -> keep-alive refresh: move to the own
+ *     blade's tail, O(1), no hashing
+ *   - lawn2_extend                     -> lazy postponement: rewrite the
+ *     deadline only; re-queue once the node reaches its blade's head
+ *   - lawn2_detach_ttl / lawn2_retime_ttl -> cancel or retime a whole TTL
+ *     class in O(1): cut its blade out, or move the blade's expiration
+ *     offset and table key
+ *   - lawn2_gtimer (optional)          -> second intrusive link per timer:
+ *     lawn2_del_group cancels all of one owner's timers in O(k)
+ *   - lawn2_add_periodic               -> periodic timers re-armed to their
+ *     own blade's tail inside the Poll, no caller re-add
+ *   - cfg.quant (optional)             -> TTLs rounded up (kernel wheel levels,
+ *     relative precision or fixed granularity) onto fewer blades, with the
+ *     error introduced reported in lawn2_stats
+ *   - lawn2_add_slack                  -> per-timer lateness bound: join the
+ *     nearest live blade within it rather than open a new TTL
+ *   - incremental table resize         -> a new TTL never pays for a whole
+ *     rehash; lawn2_reserve pre-sizes so it never even allocates
  *
  * Self-contained C11 (no glibc-only headers), portable like the wahern wheel.
  */
@@ -25,11 +64,50 @@
 typedef struct lawn2_timer {
     uint64_t ttl;                 /* bucket key, set by lawn2_add          */
     uint64_t expiration;          /* absolute expiry (now_at_add + ttl)    */
+    /* After a lawn2_retime_ttl both are stale while n is in the store (its
+     * blade carries the shift): read lawn2_expiration(). They are rewritten
+     * when n leaves it (del, fire, lawn2_seg_pop). */
     struct lawn2_timer *next, *prev;
-    int in_store;                 /* 1 while linked; guards double del/fire */
+    uint16_t in_store;            /* 1 while linked; guards double del/fire */
+    uint16_t flags;               /* LAWN2_TIMER_* below, managed by lawn2 */
+    uint32_t blade;               /* owning blade's stable index: O(1) del, no hash */
     uint64_t id;
 } lawn2_timer;
 
+/* lawn2_timer.flags */
+#define LAWN2_TIMER_PERIODIC 0x1u /* re-armed every ttl ticks instead of fired out */
+#define LAWN2_TIMER_STALE    0x2u /* lawn2_extend'ed: queued behind its real deadline */
+#define LAWN2_TIMER_GROUPED  0x4u /* a lawn2_gtimer linked into a lawn2_group */
+#define LAWN2_TIMER_AWAY     0x8u /* re-queued in another TTL's blade; ttl is its own */
+
+/* Opt-in timer groups: one owner (a connection, a tenant) holding timers on
+ * many blades. Embed a lawn2_gtimer instead of a lawn2_timer where you need
+ * it and pass &g->t wherever a lawn2_timer is taken; plain timers don't pay
+ * the extra 24 bytes. A timer leaves its group when it leaves the store
+ * (del, fire, lawn2_seg_pop); periodic ones stay in it while they re-arm. */
+typedef struct lawn2_group {
+    struct lawn2_gtimer *head;
+    uint64_t count;
+} lawn2_group;                    /* zero-initialize */
+
+typedef struct lawn2_gtimer {
+    lawn2_timer t;                /* first: a grouped lawn2_timer * casts back */
+    struct lawn2_gtimer *gnext, *gprev;
+    lawn2_group *group;
+} lawn2_gtimer;
+
+/* Drop n from its group, if it is in one (called by lawn2 itself). */
+static inline void lawn2_group_unlink(lawn2_timer *n) {
+    if (!(n->flags & LAWN2_TIMER_GROUPED)) return;
+    lawn2_gtimer *g = (lawn2_gtimer *)n;
+    if (g->gprev) g->gprev->gnext = g->gnext; else g->group->head = g->gnext;
+    if (g->gnext) g->gnext->gprev = g->gprev;
+    g->group->count--;
+    g->gnext = g->gprev = NULL;
+    g->group = NULL;
+    n->flags &= ~LAWN2_TIMER_GROUPED;
+}
+
 typedef struct lawn2 lawn2;
 
 
@@ -47,25 +125,263 @@ typedef struct caller_state_store {
 
 timer_store *init_store(void); /* Init a caller nodes store for a set timer nodes*/
 lawn2_timer *timer_for(timer_store *s, uint64_t id); /* Init and store a caller node with a given ID in the provided store */
+void reserve_store(timer_store *s, uint64_t ids); /* Pre-allocate the nodes for ids [0, ids) so timer_for never allocates for them */
 void destroy_store(timer_store *s); /* frees the caller nodes store */
 
 // ############## Timer Storage ####################
 
+/* Creation-time options for lawn2_new_config(). Zero-initialize and set only
+ * what you need: an all-zero config behaves exactly like lawn2_new(). */
+typedef struct lawn2_config {
+    unsigned flags;               /* LAWN2_* mode bits below               */
+    /* Reclaim a blade once it has been empty for this many ticks: its table
+     * slot and index are reused and the table shrinks as TTLs die out. 0
+     * keeps drained blades forever (best when the TTL set is fixed). */
+    uint64_t idle_ticks;
+    /* Event-time lateness lawn2_add_at accepts, in ticks: an arrival up to
+     * this far behind now keeps its exact deadline; a later one is treated
+     * as arriving this far behind. 0 (default) treats every arrival as now. */
+    uint64_t disorder;
+    /* TTL quantization: every pushed TTL is first rounded up by this policy
+     * (LAWN2_QUANT_* below, NONE by default), trading precision for fewer
+     * distinct TTLs, so fewer blades to Poll. See lawn2_quantize(). */
+    unsigned quant;
+    uint64_t quant_param;
+    /* Hybrid mode (scan mode only; ignored under LAWN2_INDEXED): a blade
+     * holding fewer than this many timers is cold, its head kept in an
+     * overflow min-heap the Poll pops only when due, rather than in the
+     * arrays every Poll scans. It is promoted when a push takes it to
+     * cold_max, and demoted when a Poll leaves it under cold_max / 2 or it
+     * drains. 0 (default): every blade is scanned. */
+    uint64_t cold_max;
+    /* Dense TTL domains: a TTL below direct_max finds its blade in a flat
+     * array indexed by the TTL, with no hashing or probing (4 bytes per TTL
+     * below it, allocated up front; e.g. 4096 for millisecond TTLs under
+     * 4 s). Larger TTLs still use the hash table. 0 (default): off. */
+    uint64_t direct_max;
+} lawn2_config;
+
+/* Indexed mode: non-empty blades sit in a min-heap keyed by their head's
+ * expiration. Poll pops only the blades that are actually due instead of
+ * walking every live blade, and lawn2_next_expiration() is always exact
+ * (never a stale lower bound after lawn2_del). Costs an O(log t) sift
+ * whenever a blade's head changes; pays off once t reaches the thousands. */
+#define LAWN2_INDEXED 0x1u
+/* Force the scalar due-blade scan even where the CPU has AVX2 (testing and
+ * benchmarking the kernels against each other). */
+#define LAWN2_NO_SIMD 0x2u
+
+/* cfg.quant policies. A timer may fire late by the rounding, never early;
+ * lawn2_get_stats() reports the error introduced. */
+#define LAWN2_QUANT_NONE     0u
+/* Linux kernel timer wheel levels: exact below 64 ticks, then each level of
+ * 64 buckets 8x coarser (granularity 8, 64, ... up to 2^24 ticks). Ignores
+ * quant_param. */
+#define LAWN2_QUANT_KERNEL   1u
+/* Relative precision: error at most quant_param parts per million of the
+ * TTL (10000: 1%), by keeping only its top significant bits. */
+#define LAWN2_QUANT_RELATIVE 2u
+/* Fixed granularity: round up to a multiple of quant_param ticks. */
+#define LAWN2_QUANT_FIXED    3u
+
+/* ttl as a store created with this policy and param would queue it. */
+uint64_t lawn2_quantize(unsigned policy, uint64_t param, uint64_t ttl);
+
 lawn2   *lawn2_new(void);
+lawn2   *lawn2_new_config(const lawn2_config *cfg);
 void     lawn2_free(lawn2 *l);          /* frees the store, not caller nodes */
 
 void     lawn2_add(lawn2 *l, lawn2_timer *n, uint64_t ttl); // Push, O(1)
 void     lawn2_del(lawn2 *l, lawn2_timer *n); // Pull, O(1)
+/* Push an event-time timer: expires at arrival + ttl rather than now + ttl,
+ * for events stamped slightly in the past (reordered input, a clock set
+ * back). Arrivals within cfg.disorder of now are inserted in order by a
+ * scan back from the blade's tail, bounded by what that blade was pushed
+ * in the last `disorder` ticks (O(1) when the arrival is the latest or the
+ * earliest); later ones are clamped to now - disorder, so a timer may fire
+ * late, never early. An arrival >= now is plain lawn2_add. */
+void     lawn2_add_at(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t arrival);
+/* Push a timer that may fire up to slack ticks late (timer_slack-style):
+ * it joins the blade of the smallest TTL in [ttl, ttl + slack] that has
+ * timers, else the smallest held one in that window, and only with neither
+ * gets a blade of its own, as lawn2_add. n->ttl is the TTL it was queued
+ * under. O(log B) for B TTLs held, plus the drained ones in the window; the
+ * first call builds the sorted TTL index this needs. The lateness taken is
+ * reported in lawn2_stats. slack 0 is lawn2_add. */
+void     lawn2_add_slack(lawn2 *l, lawn2_timer *n, uint64_t ttl, uint64_t slack);
+/* Push n timers at once: nodes[i] with ttls[i]. Same result as n lawn2_add
+ * calls in order, but each distinct TTL is looked up once and its timers
+ * are linked into a private chain first, then spliced onto the blade tail
+ * in one step. Built for ingest batches with a few distinct TTLs (runs of
+ * one TTL are cheapest); past 16 in one batch, the rest of it falls back to
+ * lawn2_add. */
+void     lawn2_add_batch(lawn2 *l, lawn2_timer **nodes, const uint64_t *ttls, size_t n);
+/* Pull n timers at once (e.g. every timer of a closed connection). Same
+ * result as n lawn2_del calls, but nodes and their neighbours are prefetched
+ * ahead of the unlinks, each blade whose head went is resynced once, and,
+ * in scan mode, next_expiration is made exact again with one pass at the
+ * end if a head it rested on was removed. Nodes not in the store (or listed
+ * twice) are skipped. */
+void     lawn2_del_batch(lawn2 *l, lawn2_timer **nodes, size_t n);
+/* Refresh, O(1): push n's deadline out to now + its ttl by moving it to its
+ * own blade's tail, with no hashing and no unlink/relink of the blade (the
+ * keep-alive "activity seen" path; same as lawn2_del + lawn2_add with the
+ * same ttl, minus both table lookups). A timer lawn2_extend re-queued under
+ * another TTL (LAWN2_TIMER_AWAY) goes back to its own TTL's blade instead,
+ * with one lookup. No-op if n is not in the store. */
+void     lawn2_touch(lawn2 *l, lawn2_timer *n);
+/* Postpone n's deadline to now + delay, lazily: usually O(1) writes to n
+ * alone, with no unlink and no blade touched. n keeps its queue position
+ * (flagged LAWN2_TIMER_STALE) until it reaches its blade's head, where a Poll,
+ * del or touch re-queues it at its real deadline - its own tail if that keeps
+ * the blade sorted, else the blade of its remaining time. Pays off when most
+ * timers are extended or cancelled before they ever reach the head. An
+ * earlier deadline is applied eagerly, in the blade of delay. Either way n
+ * keeps n->ttl, its own TTL (flagged LAWN2_TIMER_AWAY while queued under
+ * another), and lawn2_touch moves it back to that TTL's blade; until then a
+ * retime or detach of its TTL does not reach it. No-op for periodic timers
+ * or if n is not in the store. */
+void     lawn2_extend(lawn2 *l, lawn2_timer *n, uint64_t delay);
+/* Change one TTL class's TTL (lawn2_detach_ttl below cancels one): every
+ * timer queued under ttl, lawn2_extend'ed ones included, moves to class
+ * new_ttl and its deadline by new_ttl - ttl (either way; one already due
+ * fires at the next Poll). O(1) when new_ttl has no timers: the blade is
+ * rekeyed and carries the shift as an offset, no node is written. Else the
+ * two queues are merged, O(both). Returns the number of timers moved. Both
+ * TTLs are rounded by cfg.quant first, as for lawn2_detach_ttl. */
+uint64_t lawn2_retime_ttl(lawn2 *l, uint64_t ttl, uint64_t new_ttl);
+/* n's real deadline, whatever retimes its class has been through. */
+uint64_t lawn2_expiration(lawn2 *l, const lawn2_timer *n);
+/* Push a periodic timer, O(1): fires every `interval` ticks (>= 1) until
+ * lawn2_del. On each fire the Poll re-appends it to its own blade's tail at
+ * now + interval in the same pass (no table lookup, no caller re-add). It
+ * stays in the store, so it is never on a Poll's output list/array/segments
+ * nor in its return value: read it from lawn2_rearmed() instead. It does
+ * count against a Poll's max_fire / cap. */
+void     lawn2_add_periodic(lawn2 *l, lawn2_timer *n, uint64_t interval);
+/* Put a stored timer (added by any lawn2_add* call) into group grp, O(1),
+ * moving it out of the one it is in. No-op if it is not in the store. */
+void     lawn2_group_join(lawn2_group *grp, lawn2_gtimer *g);
+/* lawn2_add + lawn2_group_join. */
+void     lawn2_add_grouped(lawn2 *l, lawn2_gtimer *g, uint64_t ttl, lawn2_group *grp);
+/* Cancel every timer in grp, whatever its blade: O(k) for k members, same
+ * as lawn2_del on each. Returns k; grp is left empty and reusable. */
+uint64_t lawn2_del_group(lawn2 *l, lawn2_group *grp);
+/* Every Poll below returns the number of timers it handed back (list, array
+ * or segments). Periodic timers it re-armed are not among them: see
+ * lawn2_rearmed(). */
 uint64_t lawn2_tick(lawn2 *l, lawn2_timer **out_head); // Poll: +1 tick, return #expired and populate list of exired nodes in out_head
 /* Poll: jump straight to target_now (must be >= lawn2_now(l), else a no-op)
  * and fire everything due by then. Same result as calling lawn2_tick()
  * (target_now - lawn2_now(l)) times, but O(non-empty buckets) instead of
  * O(elapsed ticks) when nothing is due in between. */
 uint64_t lawn2_advance(lawn2 *l, uint64_t target_now, lawn2_timer **out_head);
+/* Budgeted Poll: like lawn2_advance, but fires at most max_fire timers and
+ * leaves the rest due. lawn2_pending() then returns 1, and the next call
+ * (with target_now <= lawn2_now(l) to stay on the current tick) resumes the
+ * drain exactly where this one stopped; each TTL's timers still fire in
+ * expiry order. Calling with a later target_now instead moves the clock and
+ * drains everything due by then. Bounds the work per event-loop iteration
+ * when a hot TTL makes a single tick fire a huge batch. */
+uint64_t lawn2_advance_budget(lawn2 *l, uint64_t target_now, uint64_t max_fire,
+                              lawn2_timer **out_head);
+int      lawn2_pending(lawn2 *l);
+/* Periodic timers fired (and re-armed) by the last Poll call; the array is
+ * owned by the store and valid until the next Poll. */
+lawn2_timer **lawn2_rearmed(lawn2 *l, size_t *n);
+
+/* Array Poll: like lawn2_advance_budget with max_fire = cap, but fired nodes
+ * are stored into buf[0..*n) (each TTL's in expiry order) instead of being
+ * chained, so the caller can prefetch and batch-process them without
+ * chasing ->next through cold nodes. A full array leaves the rest pending;
+ * call again with target_now <= lawn2_now(l) to continue. Returns *n. */
+uint64_t lawn2_advance_into(lawn2 *l, uint64_t target_now, lawn2_timer **buf,
+                            size_t cap, size_t *n);
+
+/* Ordered Poll: like lawn2_advance_budget, but the output list runs in
+ * ascending expiration order across all TTLs, from *out_head forward (the
+ * other Polls emit per-blade LIFO order). A k-way merge of the due blade
+ * prefixes, O(x + r log d) for r same-blade runs over d due blades. A call
+ * cut short by max_fire resumes in order: nothing it left pending expires
+ * before what it already fired. */
+uint64_t lawn2_advance_ordered(lawn2 *l, uint64_t target_now, uint64_t max_fire,
+                               lawn2_timer **out_head);
+
+/* Segment Poll: same as lawn2_advance_budget, except each due blade's due
+ * prefix is cut off whole and handed back as one segment instead of being
+ * unlinked node by node, so the store does O(due blades) pointer writes
+ * rather than O(expired timers). first..last are chained through ->next
+ * (NULL after last) in expiry order. Fills at most max_segs segments (one
+ * per blade; the rest stays pending as above), sets *nsegs, and returns the
+ * number of timers fired. Nodes in a segment still read in_store == 1: take
+ * them out with lawn2_seg_pop(), which finishes the unlink, and don't
+ * lawn2_del or re-add a node before it has been popped. */
+typedef struct lawn2_segment {
+    uint64_t ttl;
+    lawn2_timer *first, *last;
+    uint64_t count;
+    uint64_t exp_off;             /* lawn2_seg_pop adds it to each expiration */
+} lawn2_segment;
+
+uint64_t lawn2_advance_segments(lawn2 *l, uint64_t target_now, lawn2_segment *segs,
+                                size_t max_segs, size_t *nsegs);
+
+/* Next fired node of a segment, NULL once it is empty. */
+static inline lawn2_timer *lawn2_seg_pop(lawn2_segment *sg) {
+    lawn2_timer *n = sg->first;
+    if (!n) return NULL;
+    sg->first = n->next;
+    sg->count--;
+    n->next = n->prev = NULL;
+    n->in_store = 0;
+    lawn2_group_unlink(n);
+    n->expiration += sg->exp_off;             /* absolute again (lawn2_retime_ttl) */
+    if (!(n->flags & LAWN2_TIMER_AWAY)) n->ttl = sg->ttl;
+    n->flags &= ~(LAWN2_TIMER_STALE | LAWN2_TIMER_AWAY);  /* lawn2_detach_ttl hands them over as is */
+    return n;
+}
+/* Cancel every timer of one TTL class, O(1): its blade's queue is cut out
+ * whole into *out (expiry order, bar lawn2_extend'ed nodes) and the count
+ * returned, 0 with an empty segment if the class has none. Take the nodes
+ * out with lawn2_seg_pop() as for lawn2_advance_segments. Under cfg.quant
+ * the class is that of ttl rounded, so every TTL rounding to it. */
+uint64_t lawn2_detach_ttl(lawn2 *l, uint64_t ttl, lawn2_segment *out);
 uint64_t lawn2_size(lawn2 *l);
 uint64_t lawn2_now(lawn2 *l);
 
+/* Earliest live expiry: a lower bound by default (lawn2_del doesn't tighten
+ * it until the next Poll), exact under LAWN2_INDEXED. */
 uint64_t lawn2_next_expiration(lawn2 *l);
 void     lawn2_set_now(lawn2 *l, uint64_t now);
 
+/* Pre-size for `ttls` distinct TTLs (e.g. at startup): the table and blade
+ * arrays are allocated up front, so adds of up to that many TTLs never
+ * allocate or rehash, and idle reclamation never shrinks below it. Growth
+ * past it is incremental anyway (a few slots move per add/Poll). A request
+ * above LAWN2_RESERVE_MAX is ignored rather than allocated up front. */
+#define LAWN2_RESERVE_MAX ((uint64_t)1 << 24)
+void     lawn2_reserve(lawn2 *l, uint64_t ttls);
+
+/* Table occupancy, for sizing and for checking idle reclamation. */
+typedef struct lawn2_stats {
+    uint64_t blades;              /* TTL blades held: non-empty + not yet reclaimed */
+    uint64_t table_cap;           /* TTL table slots                       */
+    uint64_t reclaimed;           /* idle blades reclaimed so far          */
+    /* cfg.quant error over all pushes so far (re-queues included) */
+    uint64_t quant_rounded;       /* pushes whose TTL was rounded up       */
+    uint64_t quant_err_sum;       /* ticks added in total                  */
+    uint64_t quant_err_max;       /* most ticks added to one push          */
+    uint64_t quant_ppm_max;       /* largest error relative to its TTL, ppm */
+    /* lawn2_add_slack lateness */
+    uint64_t slack_adds;          /* lawn2_add_slack calls with slack > 0  */
+    uint64_t slack_coalesced;     /* of those, queued under a longer TTL   */
+    uint64_t slack_late_sum;      /* ticks late taken in total             */
+    uint64_t slack_late_max;      /* most ticks late taken by one timer    */
+    /* cfg.cold_max hybrid mode */
+    uint64_t cold_blades;         /* non-empty blades in the overflow heap */
+    uint64_t promoted;            /* cold -> scanned moves so far          */
+    uint64_t demoted;             /* scanned -> cold moves of non-empty blades */
+} lawn2_stats;
+void     lawn2_get_stats(lawn2 *l, lawn2_stats *out);
+
 #endif /* LAWN2_H */
@@ -0,0 +1,295 @@
+/* lawn2c implementation - see lawn2c.h. */
+#include "lawn2c.h"
+
+#define GOLDEN 0x9E3779B97F4A7C15ULL
+
+#define IN_STORE   0x80000000u
+#define BLADE_MASK 0x7FFFFFFFu
+
+/* Node blocks: same two-level id -> node layout as lawn2's timer_store. */
+#define BLK_BITS 12
+#define BLK_SIZE (1u << BLK_BITS)
+#define BLK_MASK (BLK_SIZE - 1)
+
+/* One TTL blade. Never moves once created, so nodes can hold its index.
+ * Node expirations are base + exp_off; base is the first node's expiration
+ * when the blade (re)fills and is only moved by rebase(). */
+typedef struct cblade {
+    uint64_t ttl;
+    uint64_t base;
+    uint32_t head, tail;     /* node ids, LAWN2C_NIL when empty */
+    uint32_t pos;            /* slot in live_exp/live_blade while non-empty */
+} cblade;
+
+/* TTL -> blade index (open addressing). */
+typedef struct slot {
+    uint64_t ttl;
+    uint32_t blade;
+    uint32_t used;
+} slot;
+
+struct lawn2c {
+    uint64_t now;
+    lawn2c_timer **blocks;   /* id-addressed node blocks */
+    size_t   nblocks;
+    cblade  *blades;         /* append-only, indexed by node->blade */
+    uint32_t nblades, blades_cap;
+    slot    *tab;
+    size_t   cap;            /* power of two */
+    unsigned bits;           /* cap == 1u << bits */
+    uint64_t live;
+    uint64_t next_expiration;/* lower bound on earliest live expiry */
+    uint64_t *live_exp;      /* head expiration of each non-empty blade */
+    uint32_t *live_blade;    /* parallel to live_exp; capacity blades_cap */
+    uint32_t nlive;
+};
+
+static inline lawn2c_timer *node(const lawn2c *l, uint32_t id) {
+    return &l->blocks[id >> BLK_BITS][id & BLK_MASK];
+}
+
+static inline uint64_t node_exp(const lawn2c *l, const lawn2c_timer *n) {
+    return l->blades[n->blade & BLADE_MASK].base + n->exp_off;
+}
+
+static void ensure_node(lawn2c *l, uint32_t id) {
+    size_t block_index = (size_t)(id >> BLK_BITS);
+    if (block_index < l->nblocks) return;
+    size_t old = l->nblocks;
+    l->nblocks = block_index + 1;
+    l->blocks = realloc(l->blocks, l->nblocks * sizeof *l->blocks);
+    for (size_t i = old; i < l->nblocks; i++)
+        l->blocks[i] = calloc(BLK_SIZE, sizeof(lawn2c_timer));  /* blade 0: not in store */
+}
+
+// ###################### internal datastructure managment #############
+
+static slot *find_slot(lawn2c *l, uint64_t ttl) {
+    size_t mask = l->cap - 1;
+    size_t i = (size_t)((ttl * GOLDEN) >> (64 - l->bits));
+    for (;;) {
+        slot *s = &l->tab[i & mask];
+        if (!s->used || s->ttl == ttl) return s;
+        i++;
+    }
+}
+
+/* Blades never move, so a grow only rehashes (ttl, index) pairs. */
+static void grow(lawn2c *l) {
+    slot *ot = l->tab;
+    size_t ocap = l->cap;
+    l->bits++;
+    l->cap = (size_t)1 << l->bits;
+    l->tab = calloc(l->cap, sizeof(slot));
+    for (size_t i = 0; i < ocap; i++)
+        if (ot[i].used) *find_slot(l, ot[i].ttl) = ot[i];
+    free(ot);
+}
+
+static uint32_t blade_for(lawn2c *l, uint64_t ttl) {
+    if (((size_t)l->nblades + 1) * 10 >= l->cap * 7) grow(l);  /* keep load < 0.7 */
+    slot *s = find_slot(l, ttl);
+    if (s->used) return s->blade;
+    if (l->nblades == l->blades_cap) {
+        l->blades_cap = l->blades_cap ? l->blades_cap * 2 : 16;
+        l->blades = realloc(l->blades, l->blades_cap * sizeof *l->blades);
+        l->live_exp = realloc(l->live_exp, l->blades_cap * sizeof *l->live_exp);
+        l->live_blade = realloc(l->live_blade, l->blades_cap * sizeof *l->live_blade);
+    }
+    uint32_t bi = l->nblades++;
+    l->blades[bi] = (cblade){ ttl, 0, LAWN2C_NIL, LAWN2C_NIL, 0 };
+    s->used = 1;
+    s->ttl = ttl;
+    s->blade = bi;
+    return bi;
+}
+
+static void live_link(lawn2c *l, uint32_t bi) {
+    cblade *b = &l->blades[bi];
+    b->pos = l->nlive++;
+    l->live_exp[b->pos] = b->base + node(l, b->head)->exp_off;
+    l->live_blade[b->pos] = bi;
+}
+
+static void live_unlink(lawn2c *l, cblade *b) {
+    uint32_t i = b->pos, last = --l->nlive;
+    if (i != last) {
+        l->live_exp[i] = l->live_exp[last];
+        l->live_blade[i] = l->live_blade[last];
+        l->blades[l->live_blade[i]].pos = i;
+    }
+}
+
+/* Move b's base to the earliest of its nodes and `exp`, so `exp` fits 32 bits
+ * alongside them: forward after ~2^32 ticks of continuous use, backward when
+ * lawn2c_set_now() moved the clock back. O(blade length), but rare. */
+static int rebase(lawn2c *l, cblade *b, uint64_t exp) {
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (uint32_t id = b->head; id != LAWN2C_NIL; id = node(l, id)->next) {
+        uint32_t off = node(l, id)->exp_off;
+        if (off < lo) lo = off;
+        if (off > hi) hi = off;
+    }
+    uint64_t first = b->base + lo, last = b->base + hi;
+    if (exp < first) first = exp;
+    if (exp > last) last = exp;
+    if (last - first > UINT32_MAX) return -1;
+    for (uint32_t id = b->head; id != LAWN2C_NIL; id = node(l, id)->next)
+        node(l, id)->exp_off = (uint32_t)(b->base + node(l, id)->exp_off - first);
+    b->base = first;
+    return 0;
+}
+
+// ######################## user facing APIs ###########################
+
+lawn2c *lawn2c_new(void) {
+    lawn2c *l = calloc(1, sizeof *l);
+    l->bits = 4;
+    l->cap = (size_t)1 << l->bits;
+    l->tab = calloc(l->cap, sizeof(slot));
+    l->next_expiration = UINT64_MAX;
+    return l;
+}
+
+void lawn2c_free(lawn2c *l) {
+    if (!l) return;
+    for (size_t i = 0; i < l->nblocks; i++) free(l->blocks[i]);
+    free(l->blocks);
+    free(l->blades);
+    free(l->live_exp);
+    free(l->live_blade);
+    free(l->tab);
+    free(l);
+}
+
+int lawn2c_add(lawn2c *l, uint32_t id, uint64_t ttl) {
+    if (id == LAWN2C_NIL || ttl > UINT32_MAX) return -1;
+    ensure_node(l, id);
+    lawn2c_timer *n = node(l, id);
+    if (n->blade & IN_STORE) lawn2c_del(l, id);
+    uint32_t bi = blade_for(l, ttl);
+    cblade *b = &l->blades[bi];
+    uint64_t exp = l->now + ttl;
+    if (b->head == LAWN2C_NIL) b->base = exp;
+    else if ((exp < b->base || exp - b->base > UINT32_MAX) && rebase(l, b, exp)) return -1;
+    n->exp_off = (uint32_t)(exp - b->base);
+    n->blade = bi | IN_STORE;
+    /* append at tail; head stays the earliest */
+    n->next = LAWN2C_NIL;
+    n->prev = b->tail;
+    if (b->tail != LAWN2C_NIL) {
+        node(l, b->tail)->next = id;
+        b->tail = id;
+    } else {
+        b->head = b->tail = id;
+        live_link(l, bi);
+    }
+    l->live++;
+    if (exp < l->next_expiration) l->next_expiration = exp;
+    return 0;
+}
+
+int lawn2c_del(lawn2c *l, uint32_t id) {
+    if (id == LAWN2C_NIL || (size_t)(id >> BLK_BITS) >= l->nblocks) return 0;
+    lawn2c_timer *n = node(l, id);
+    if (!(n->blade & IN_STORE)) return 0;
+    cblade *b = &l->blades[n->blade & BLADE_MASK];
+    if (n->prev != LAWN2C_NIL) node(l, n->prev)->next = n->next; else b->head = n->next;
+    if (n->next != LAWN2C_NIL) node(l, n->next)->prev = n->prev; else b->tail = n->prev;
+    if (b->head == LAWN2C_NIL) live_unlink(l, b);
+    else if (n->prev == LAWN2C_NIL) l->live_exp[b->pos] = b->base + node(l, b->head)->exp_off;
+    n->next = n->prev = LAWN2C_NIL;
+    n->blade = 0;
+    l->live--;
+    return 1;
+}
+
+/* Pop b's due prefix onto *out_head (chained through node->next). */
+static uint64_t expire_blade(lawn2c *l, cblade *b, uint64_t now, uint32_t *out_head) {
+    uint64_t fired = 0;
+    uint64_t due_off = now - b->base;   /* heads never sit below base */
+    while (b->head != LAWN2C_NIL) {
+        uint32_t id = b->head;
+        lawn2c_timer *n = node(l, id);
+        if (n->exp_off > due_off) break;
+        b->head = n->next;
+        if (b->head != LAWN2C_NIL) node(l, b->head)->prev = LAWN2C_NIL;
+        else b->tail = LAWN2C_NIL;
+        n->blade = 0;
+        n->prev = LAWN2C_NIL;
+        n->next = out_head ? *out_head : LAWN2C_NIL;
+        if (out_head) *out_head = id;
+        fired++;
+    }
+    return fired;
+}
+
+static uint64_t collect_expired(lawn2c *l, uint64_t now, uint32_t *out_head) {
+    if (out_head) *out_head = LAWN2C_NIL;
+    if (now < l->next_expiration) return 0;   /* O(1) empty advance */
+
+    uint64_t fired = 0, ne = UINT64_MAX;
+    uint32_t i = 0;
+    while (i < l->nlive) {
+        if (l->live_exp[i] > now) {
+            if (l->live_exp[i] < ne) ne = l->live_exp[i];
+            i++;
+            continue;
+        }
+        cblade *b = &l->blades[l->live_blade[i]];
+        fired += expire_blade(l, b, now, out_head);
+        if (b->head == LAWN2C_NIL) {
+            live_unlink(l, b);                  /* the last blade moves into i */
+        } else {
+            l->live_exp[i] = b->base + node(l, b->head)->exp_off;
+            if (l->live_exp[i] < ne) ne = l->live_exp[i];
+            i++;
+        }
+    }
+    l->live -= fired;
+    l->next_expiration = ne;
+    return fired;
+}
+
+uint64_t lawn2c_tick(lawn2c *l, uint32_t *out_head) {
+    l->now++;
+    return collect_expired(l, l->now, out_head);
+}
+
+uint64_t lawn2c_advance(lawn2c *l, uint64_t target_now, uint32_t *out_head) {
+    if (target_now <= l->now) {
+        if (out_head) *out_head = LAWN2C_NIL;
+        return 0;
+    }
+    l->now = target_now;
+    return collect_expired(l, target_now, out_head);
+}
+
+uint32_t lawn2c_next(lawn2c *l, uint32_t id) {
+    return node(l, id)->next;
+}
+
+int lawn2c_in_store(lawn2c *l, uint32_t id) {
+    if ((size_t)(id >> BLK_BITS) >= l->nblocks) return 0;
+    return (node(l, id)->blade & IN_STORE) != 0;
+}
+
+uint64_t lawn2c_expiration(lawn2c *l, uint32_t id) {
+    return node_exp(l, node(l, id));
+}
+
+uint64_t lawn2c_size(lawn2c *l) {
+    return l->live;
+}
+
+uint64_t lawn2c_now(lawn2c *l) {
+    return l->now;
+}
+
+uint64_t lawn2c_next_expiration(lawn2c *l) {
+    return l ? l->next_expiration : UINT64_MAX;
+}
+
+void lawn2c_set_now(lawn2c *l, uint64_t now) {
+    if (l) l->now = now;
+}
@@ -0,0 +1,62 @@
+/* lawn2c - compact, index-linked variant of lawn2 for 100M+ timer populations.
+ *
+ * Same Queue-Map algorithm and cost model as src/lawn2.c (map of TTL ->
+ * self-sorted queue; Push O(1), Pull O(1), Poll O(max(x,t))), but the node
+ * shrinks from 48 to 16 bytes:
+ *   - 32-bit node indices instead of 64-bit next/prev pointers. A node's index
+ *     is its timer id: nodes live in id-addressed blocks owned by the store
+ *     (the timer_store layout from lawn2.h), so the id needs no field either
+ *   - expiration kept as a 32-bit offset from its blade's base expiration
+ *   - ttl lives only in the blade; the node keeps a 31-bit blade index with
+ *     the in_store flag packed into the top bit
+ * Blades sit in a stable, append-only array (a node's blade index never
+ * moves); the TTL -> blade hash table only stores indices.
+ *
+ * Limits: ids below LAWN2C_NIL (2^32 - 1), fewer than 2^31 distinct TTLs, and
+ * TTLs below 2^32 ticks (a blade's timers must fit a 32-bit offset span).
+ *
+ * Self-contained C11, portable like lawn2.
+ */
+#ifndef LAWN2C_H
+#define LAWN2C_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LAWN2C_NIL UINT32_MAX          /* "no node" index / list terminator */
+
+/* 16-byte node, addressed by id. Read-only for callers: use the accessors. */
+typedef struct lawn2c_timer {
+    uint32_t next, prev;              /* ids of blade neighbours, or NIL    */
+    uint32_t exp_off;                 /* expiration - blade base           */
+    uint32_t blade;                   /* bit 31: in store, bits 0-30: blade */
+} lawn2c_timer;
+
+typedef struct lawn2c lawn2c;
+
+lawn2c  *lawn2c_new(void);
+void     lawn2c_free(lawn2c *l);        /* frees the store and its node blocks */
+
+/* Push, O(1). Returns 0, or -1 if id >= LAWN2C_NIL or ttl >= 2^32 ticks (or
+ * the blade's pending span no longer fits 32 bits because Poll was starved
+ * for that long; the id is left out of the store). Re-adding a live id moves
+ * it, like lawn2_del + lawn2_add. */
+int      lawn2c_add(lawn2c *l, uint32_t id, uint64_t ttl);
+int      lawn2c_del(lawn2c *l, uint32_t id);   /* Pull, O(1): 1 removed, 0 absent */
+/* Poll: +1 tick. Expired ids are chained through lawn2c_next() starting at
+ * *out_head (LAWN2C_NIL terminated; may be NULL to only count). */
+uint64_t lawn2c_tick(lawn2c *l, uint32_t *out_head);
+/* Poll: jump to target_now (no-op unless > lawn2c_now(l)), like lawn2_advance. */
+uint64_t lawn2c_advance(lawn2c *l, uint64_t target_now, uint32_t *out_head);
+
+uint32_t lawn2c_next(lawn2c *l, uint32_t id);  /* walk a Poll's output list */
+int      lawn2c_in_store(lawn2c *l, uint32_t id);
+uint64_t lawn2c_expiration(lawn2c *l, uint32_t id); /* absolute; id must be in store */
+uint64_t lawn2c_size(lawn2c *l);
+uint64_t lawn2c_now(lawn2c *l);
+uint64_t lawn2c_next_expiration(lawn2c *l);     /* lower bound, as in lawn2 */
+/* Moves the clock either way, as lawn2_set_now; later adds expire from the
+ * new now even if that is before pending expirations of the same TTL. */
+void     lawn2c_set_now(lawn2c *l, uint64_t now);
+
+#endif /* LAWN2C_H */
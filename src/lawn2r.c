@@ -0,0 +1,381 @@
+/* lawn2r implementation - see lawn2r.h. */
+#include "lawn2r.h"
+
+#define GOLDEN 0x9E3779B97F4A7C15ULL
+
+#define IN_STORE   0x80000000u
+#define BLADE_MASK 0x7FFFFFFFu
+
+/* Node blocks: same two-level id -> node layout as lawn2's timer_store. */
+#define BLK_BITS 12
+#define BLK_SIZE (1u << BLK_BITS)
+#define BLK_MASK (BLK_SIZE - 1)
+
+/* 127 16-byte entries + the link: a 2 KiB chunk, 32 cache lines of entries. */
+#define CHUNK_ENTRIES 127
+/* How many entries ahead a Poll prefetches the generation check. */
+#define PREFETCH_AHEAD 8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
+/* A queued timer. Live while gen still matches its node's generation. */
+typedef struct rentry {
+    uint64_t exp;
+    uint32_t id;
+    uint32_t gen;
+} rentry;
+
+typedef struct rchunk {
+    struct rchunk *next;
+    rentry e[CHUNK_ENTRIES];
+} rchunk;
+
+/* Per-id state: the generation its live entry carries, and its blade. */
+typedef struct rnode {
+    uint32_t gen;
+    uint32_t blade;          /* bit 31: in store, bits 0-30: blade */
+} rnode;
+
+/* One TTL blade: entries [head->e[hpos], tail->e[tpos]) in append order,
+ * which is expiry order. Never moves once created. */
+typedef struct rblade {
+    uint64_t ttl;
+    rchunk  *head, *tail;    /* NULL when nent == 0 */
+    uint32_t hpos, tpos;     /* next entry to consume / to fill */
+    uint64_t nent;           /* queued entries, tombstones included */
+    uint64_t nlive;          /* live ones among them */
+    uint32_t pos;            /* slot in live_exp/live_blade while non-empty */
+} rblade;
+
+/* TTL -> blade index (open addressing). */
+typedef struct slot {
+    uint64_t ttl;
+    uint32_t blade;
+    uint32_t used;
+} slot;
+
+struct lawn2r {
+    uint64_t now;
+    rnode  **blocks;         /* id-addressed node blocks */
+    size_t   nblocks;
+    rblade  *blades;         /* append-only, indexed by node->blade */
+    uint32_t nblades, blades_cap;
+    slot    *tab;
+    size_t   cap;            /* power of two */
+    unsigned bits;           /* cap == 1u << bits */
+    rchunk  *free_chunks;    /* drained chunks, reused before malloc */
+    uint64_t live;
+    uint64_t next_expiration;/* lower bound on earliest live expiry */
+    uint64_t *live_exp;      /* head entry expiration of each non-empty blade */
+    uint32_t *live_blade;    /* parallel to live_exp; capacity blades_cap */
+    uint32_t nlive;
+    uint32_t *fired;         /* ids the last Poll fired */
+    size_t   nfired, fired_cap;
+};
+
+static inline rnode *node(const lawn2r *l, uint32_t id) {
+    return &l->blocks[id >> BLK_BITS][id & BLK_MASK];
+}
+
+static inline uint64_t head_exp(const rblade *b) {
+    return b->head->e[b->hpos].exp;
+}
+
+static void ensure_node(lawn2r *l, uint32_t id) {
+    size_t block_index = (size_t)(id >> BLK_BITS);
+    if (block_index < l->nblocks) return;
+    size_t old = l->nblocks;
+    l->nblocks = block_index + 1;
+    l->blocks = realloc(l->blocks, l->nblocks * sizeof *l->blocks);
+    for (size_t i = old; i < l->nblocks; i++)
+        l->blocks[i] = calloc(BLK_SIZE, sizeof(rnode));  /* blade 0: not in store */
+}
+
+// ###################### internal datastructure managment #############
+
+static slot *find_slot(lawn2r *l, uint64_t ttl) {
+    size_t mask = l->cap - 1;
+    size_t i = (size_t)((ttl * GOLDEN) >> (64 - l->bits));
+    for (;;) {
+        slot *s = &l->tab[i & mask];
+        if (!s->used || s->ttl == ttl) return s;
+        i++;
+    }
+}
+
+/* Blades never move, so a grow only rehashes (ttl, index) pairs. */
+static void grow(lawn2r *l) {
+    slot *ot = l->tab;
+    size_t ocap = l->cap;
+    l->bits++;
+    l->cap = (size_t)1 << l->bits;
+    l->tab = calloc(l->cap, sizeof(slot));
+    for (size_t i = 0; i < ocap; i++)
+        if (ot[i].used) *find_slot(l, ot[i].ttl) = ot[i];
+    free(ot);
+}
+
+static uint32_t blade_for(lawn2r *l, uint64_t ttl) {
+    if (((size_t)l->nblades + 1) * 10 >= l->cap * 7) grow(l);  /* keep load < 0.7 */
+    slot *s = find_slot(l, ttl);
+    if (s->used) return s->blade;
+    if (l->nblades == l->blades_cap) {
+        l->blades_cap = l->blades_cap ? l->blades_cap * 2 : 16;
+        l->blades = realloc(l->blades, l->blades_cap * sizeof *l->blades);
+        l->live_exp = realloc(l->live_exp, l->blades_cap * sizeof *l->live_exp);
+        l->live_blade = realloc(l->live_blade, l->blades_cap * sizeof *l->live_blade);
+    }
+    uint32_t bi = l->nblades++;
+    l->blades[bi] = (rblade){ ttl, NULL, NULL, 0, 0, 0, 0, 0 };
+    s->used = 1;
+    s->ttl = ttl;
+    s->blade = bi;
+    return bi;
+}
+
+static void live_link(lawn2r *l, uint32_t bi) {
+    rblade *b = &l->blades[bi];
+    b->pos = l->nlive++;
+    l->live_exp[b->pos] = head_exp(b);
+    l->live_blade[b->pos] = bi;
+}
+
+static void live_unlink(lawn2r *l, rblade *b) {
+    uint32_t i = b->pos, last = --l->nlive;
+    if (i != last) {
+        l->live_exp[i] = l->live_exp[last];
+        l->live_blade[i] = l->live_blade[last];
+        l->blades[l->live_blade[i]].pos = i;
+    }
+}
+
+// ###################### chunk rings ##################################
+
+static rchunk *chunk_get(lawn2r *l) {
+    rchunk *c = l->free_chunks;
+    if (c) l->free_chunks = c->next;
+    else c = malloc(sizeof *c);
+    c->next = NULL;
+    return c;
+}
+
+/* Return c and every chunk after it to the pool. */
+static void chunks_put(lawn2r *l, rchunk *c) {
+    while (c) {
+        rchunk *nx = c->next;
+        c->next = l->free_chunks;
+        l->free_chunks = c;
+        c = nx;
+    }
+}
+
+static void append(lawn2r *l, rblade *b, rentry e) {
+    if (!b->tail || b->tpos == CHUNK_ENTRIES) {
+        rchunk *c = chunk_get(l);
+        if (b->tail) b->tail->next = c;
+        else { b->head = c; b->hpos = 0; }
+        b->tail = c;
+        b->tpos = 0;
+    }
+    b->tail->e[b->tpos++] = e;
+    b->nent++;
+}
+
+/* Drop every entry (all tombstones by now) and hand the chunks back. */
+static void reset(lawn2r *l, rblade *b) {
+    chunks_put(l, b->head);
+    b->head = b->tail = NULL;
+    b->hpos = b->tpos = 0;
+    b->nent = 0;
+}
+
+/* Squeeze b's tombstones out in one sequential pass, keeping append order,
+ * and release the chunks left over. Only called with nlive > 0, and only
+ * once tombstones outnumber live entries 2:1, so it is O(1) amortized per
+ * Pull that made one. */
+static void compact(lawn2r *l, rblade *b) {
+    rchunk *rc = b->head, *wc = b->head;
+    uint32_t rp = b->hpos, wp = b->hpos;
+    for (uint64_t k = b->nent; k; k--) {
+        if (rp == CHUNK_ENTRIES) { rc = rc->next; rp = 0; }
+        rentry e = rc->e[rp++];
+        if (node(l, e.id)->gen != e.gen) continue;
+        if (wp == CHUNK_ENTRIES) { wc = wc->next; wp = 0; }
+        wc->e[wp++] = e;
+    }
+    chunks_put(l, wc->next);
+    wc->next = NULL;
+    b->tail = wc;
+    b->tpos = wp;
+    b->nent = b->nlive;
+}
+
+// ######################## user facing APIs ###########################
+
+lawn2r *lawn2r_new(void) {
+    lawn2r *l = calloc(1, sizeof *l);
+    l->bits = 4;
+    l->cap = (size_t)1 << l->bits;
+    l->tab = calloc(l->cap, sizeof(slot));
+    l->next_expiration = UINT64_MAX;
+    return l;
+}
+
+void lawn2r_free(lawn2r *l) {
+    if (!l) return;
+    for (size_t i = 0; i < l->nblocks; i++) free(l->blocks[i]);
+    for (uint32_t i = 0; i < l->nblades; i++) chunks_put(l, l->blades[i].head);
+    while (l->free_chunks) {
+        rchunk *c = l->free_chunks;
+        l->free_chunks = c->next;
+        free(c);
+    }
+    free(l->blocks);
+    free(l->blades);
+    free(l->live_exp);
+    free(l->live_blade);
+    free(l->tab);
+    free(l->fired);
+    free(l);
+}
+
+int lawn2r_add(lawn2r *l, uint32_t id, uint64_t ttl) {
+    if (id == LAWN2R_NIL) return -1;
+    ensure_node(l, id);
+    rnode *n = node(l, id);
+    if (n->blade & IN_STORE) lawn2r_del(l, id);
+    uint32_t bi = blade_for(l, ttl);
+    rblade *b = &l->blades[bi];
+    uint64_t exp = l->now + ttl;
+    /* append at tail; head stays the earliest */
+    append(l, b, (rentry){ exp, id, n->gen });
+    n->blade = bi | IN_STORE;
+    b->nlive++;
+    if (b->nent == 1) live_link(l, bi);
+    l->live++;
+    if (exp < l->next_expiration) l->next_expiration = exp;
+    return 0;
+}
+
+int lawn2r_del(lawn2r *l, uint32_t id) {
+    if (id == LAWN2R_NIL || (size_t)(id >> BLK_BITS) >= l->nblocks) return 0;
+    rnode *n = node(l, id);
+    if (!(n->blade & IN_STORE)) return 0;
+    rblade *b = &l->blades[n->blade & BLADE_MASK];
+    n->gen++;                                   /* its entry is a tombstone now */
+    n->blade = 0;
+    l->live--;
+    if (!--b->nlive) {
+        reset(l, b);
+        live_unlink(l, b);
+    } else if (b->nent - b->nlive > 2 * b->nlive + CHUNK_ENTRIES) {
+        compact(l, b);
+        l->live_exp[b->pos] = head_exp(b);
+    }
+    /* otherwise the head entry, tombstone or not, is still a lower bound */
+    return 1;
+}
+
+static void fire(lawn2r *l, uint32_t id) {
+    if (l->nfired == l->fired_cap) {
+        l->fired_cap = l->fired_cap ? l->fired_cap * 2 : 256;
+        l->fired = realloc(l->fired, l->fired_cap * sizeof *l->fired);
+    }
+    l->fired[l->nfired++] = id;
+}
+
+/* Consume b's due entries in order, firing the live ones. */
+static uint64_t expire_blade(lawn2r *l, rblade *b, uint64_t now) {
+    uint64_t fired = 0;
+    while (b->nent && head_exp(b) <= now) {
+        rentry *e = &b->head->e[b->hpos];
+        if (b->hpos + PREFETCH_AHEAD < CHUNK_ENTRIES && b->nent > PREFETCH_AHEAD)
+            PREFETCH(node(l, e[PREFETCH_AHEAD].id));
+        rnode *n = node(l, e->id);
+        if (n->gen == e->gen) {
+            n->blade = 0;
+            fire(l, e->id);
+            fired++;
+        }
+        b->nent--;
+        if (++b->hpos == CHUNK_ENTRIES && b->nent) {
+            rchunk *c = b->head;
+            b->head = c->next;
+            b->hpos = 0;
+            c->next = NULL;
+            chunks_put(l, c);
+        }
+    }
+    b->nlive -= fired;
+    if (!b->nlive) reset(l, b);                 /* only tombstones left, if any */
+    return fired;
+}
+
+static uint64_t collect_expired(lawn2r *l, uint64_t now, const uint32_t **fired_ids) {
+    l->nfired = 0;
+    if (fired_ids) *fired_ids = l->fired;
+    if (now < l->next_expiration) return 0;   /* O(1) empty advance */
+
+    uint64_t fired = 0, ne = UINT64_MAX;
+    uint32_t i = 0;
+    while (i < l->nlive) {
+        if (l->live_exp[i] > now) {
+            if (l->live_exp[i] < ne) ne = l->live_exp[i];
+            i++;
+            continue;
+        }
+        rblade *b = &l->blades[l->live_blade[i]];
+        fired += expire_blade(l, b, now);
+        if (!b->nent) {
+            live_unlink(l, b);                  /* the last blade moves into i */
+        } else {
+            l->live_exp[i] = head_exp(b);
+            if (l->live_exp[i] < ne) ne = l->live_exp[i];
+            i++;
+        }
+    }
+    l->live -= fired;
+    l->next_expiration = ne;
+    if (fired_ids) *fired_ids = l->fired;     /* fire() may have moved it */
+    return fired;
+}
+
+uint64_t lawn2r_tick(lawn2r *l, const uint32_t **fired) {
+    l->now++;
+    return collect_expired(l, l->now, fired);
+}
+
+uint64_t lawn2r_advance(lawn2r *l, uint64_t target_now, const uint32_t **fired) {
+    if (target_now <= l->now) {
+        l->nfired = 0;
+        if (fired) *fired = l->fired;
+        return 0;
+    }
+    l->now = target_now;
+    return collect_expired(l, target_now, fired);
+}
+
+int lawn2r_in_store(lawn2r *l, uint32_t id) {
+    if ((size_t)(id >> BLK_BITS) >= l->nblocks) return 0;
+    return (node(l, id)->blade & IN_STORE) != 0;
+}
+
+uint64_t lawn2r_size(lawn2r *l) {
+    return l->live;
+}
+
+uint64_t lawn2r_now(lawn2r *l) {
+    return l->now;
+}
+
+uint64_t lawn2r_next_expiration(lawn2r *l) {
+    return l ? l->next_expiration : UINT64_MAX;
+}
+
+void lawn2r_set_now(lawn2r *l, uint64_t now) {
+    if (l) l->now = now;
+}
@@ -0,0 +1,51 @@
+/* lawn2r - ring-buffer-blade variant of lawn2 for expiry-heavy workloads.
+ *
+ * Same Queue-Map algorithm and cost model as src/lawn2.c (map of TTL ->
+ * self-sorted queue; Push O(1), Pull O(1), Poll O(max(x,t))), but a blade is
+ * no longer a linked list of nodes scattered over the caller's memory:
+ *   - each blade is a chain of fixed-size chunks of (expiration, id, gen)
+ *     entries, appended at the tail and consumed at the head; drained chunks
+ *     go back to a store-wide pool, so the chain behaves as a ring
+ *   - Pull leaves a tombstone: it bumps the id's generation counter, and an
+ *     entry whose generation no longer matches is skipped when consumed
+ *   - Poll is a sequential scan of each due blade's entries (prefetcher
+ *     friendly); the only random access, the id's generation check, is
+ *     prefetched a few entries ahead
+ * The per-id node shrinks to 8 bytes (generation + blade index). A blade is
+ * compacted in place once its tombstones outnumber its live entries by 2:1,
+ * so cancel-heavy churn cannot grow it without bound.
+ *
+ * Ids are dense-ish uint32 like lawn2c (below LAWN2R_NIL). Self-contained
+ * C11, portable like lawn2.
+ */
+#ifndef LAWN2R_H
+#define LAWN2R_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define LAWN2R_NIL UINT32_MAX          /* reserved, never a valid id */
+
+typedef struct lawn2r lawn2r;
+
+lawn2r  *lawn2r_new(void);
+void     lawn2r_free(lawn2r *l);        /* frees the store, its nodes and chunks */
+
+/* Push, O(1): an entry appended to the TTL's ring. Returns 0, or -1 if
+ * id == LAWN2R_NIL. Re-adding a live id moves it, like lawn2_del + lawn2_add. */
+int      lawn2r_add(lawn2r *l, uint32_t id, uint64_t ttl);
+/* Pull, O(1) amortized: tombstones the id's entry. 1 removed, 0 absent. */
+int      lawn2r_del(lawn2r *l, uint32_t id);
+/* Poll: +1 tick. Returns #expired; if fired != NULL, *fired points at their
+ * ids, in per-TTL expiry order, valid until the next Poll. */
+uint64_t lawn2r_tick(lawn2r *l, const uint32_t **fired);
+/* Poll: jump to target_now (no-op unless > lawn2r_now(l)), like lawn2_advance. */
+uint64_t lawn2r_advance(lawn2r *l, uint64_t target_now, const uint32_t **fired);
+
+int      lawn2r_in_store(lawn2r *l, uint32_t id);
+uint64_t lawn2r_size(lawn2r *l);
+uint64_t lawn2r_now(lawn2r *l);
+uint64_t lawn2r_next_expiration(lawn2r *l);     /* lower bound, as in lawn2 */
+void     lawn2r_set_now(lawn2r *l, uint64_t now);
+
+#endif /* LAWN2R_H */
@@ -0,0 +1,114 @@
+/* lawn2w implementation - see lawn2w.h. */
+#include "lawn2w.h"
+
+#define IDLE UINT64_MAX
+
+/* 4-ary min-heap of (watermark, input) entries: half the depth of a binary
+ * heap, and a sift compares entries in place without chasing the input's
+ * state. pos[] maps an input back to its entry. */
+#define ARITY 4
+
+typedef struct wm_ent {
+    uint64_t wm;             /* IDLE while idle */
+    uint32_t input;
+} wm_ent;
+
+struct lawn2w {
+    lawn2    *l;
+    uint32_t  n;
+    wm_ent   *heap;
+    uint32_t *pos;           /* input -> its heap slot */
+};
+
+static void heap_set(lawn2w *w, uint32_t i, wm_ent e) {
+    w->heap[i] = e;
+    w->pos[e.input] = i;
+}
+
+static void sift_up(lawn2w *w, uint32_t i) {
+    wm_ent x = w->heap[i];
+    while (i) {
+        uint32_t p = (i - 1) / ARITY;
+        if (w->heap[p].wm <= x.wm) break;
+        heap_set(w, i, w->heap[p]);
+        i = p;
+    }
+    heap_set(w, i, x);
+}
+
+static void sift_down(lawn2w *w, uint32_t i) {
+    wm_ent x = w->heap[i];
+    for (;;) {
+        uint32_t c = ARITY * i + 1, end = c + ARITY < w->n ? c + ARITY : w->n;
+        if (c >= w->n) break;
+        for (uint32_t d = c + 1; d < end; d++)
+            if (w->heap[d].wm < w->heap[c].wm) c = d;
+        if (x.wm <= w->heap[c].wm) break;
+        heap_set(w, i, w->heap[c]);
+        i = c;
+    }
+    heap_set(w, i, x);
+}
+
+lawn2w *lawn2w_new(lawn2 *l, uint32_t ninputs) {
+    lawn2w *w = calloc(1, sizeof *w);
+    w->l = l;
+    w->n = ninputs;
+    w->heap = malloc(ninputs * sizeof *w->heap);
+    w->pos = malloc(ninputs * sizeof *w->pos);
+    for (uint32_t i = 0; i < ninputs; i++)     /* all equal: already a heap */
+        heap_set(w, i, (wm_ent){ lawn2_now(l), i });
+    return w;
+}
+
+void lawn2w_free(lawn2w *w) {
+    if (!w) return;
+    free(w->heap);
+    free(w->pos);
+    free(w);
+}
+
+uint64_t lawn2w_watermark(lawn2w *w) {
+    return w->n ? w->heap[0].wm : IDLE;
+}
+
+uint64_t lawn2w_input(lawn2w *w, uint32_t input) {
+    return w->heap[w->pos[input]].wm;
+}
+
+/* Advance the store to the combined watermark if it moved past it. */
+static uint64_t drive(lawn2w *w, lawn2_timer **out_head) {
+    uint64_t m = lawn2w_watermark(w);
+    if (m == IDLE || m <= lawn2_now(w->l)) {
+        if (out_head) *out_head = NULL;
+        return 0;
+    }
+    return lawn2_advance(w->l, m, out_head);
+}
+
+uint64_t lawn2w_update(lawn2w *w, uint32_t input, uint64_t wm, lawn2_timer **out_head) {
+    uint32_t i = w->pos[input];
+    uint64_t old = w->heap[i].wm;
+    if (old != IDLE && wm <= old) {
+        if (out_head) *out_head = NULL;
+        return 0;
+    }
+    if (wm < lawn2_now(w->l)) wm = lawn2_now(w->l);   /* resuming behind the others */
+    if (wm == IDLE) wm = IDLE - 1;
+    w->heap[i].wm = wm;
+    if (wm < old) sift_up(w, i);                /* only an idle input's key drops */
+    else sift_down(w, i);
+    /* the minimum can only have moved if this input held it */
+    if (i && w->pos[input]) {
+        if (out_head) *out_head = NULL;
+        return 0;
+    }
+    return drive(w, out_head);
+}
+
+uint64_t lawn2w_idle(lawn2w *w, uint32_t input, lawn2_timer **out_head) {
+    uint32_t i = w->pos[input];
+    w->heap[i].wm = IDLE;
+    sift_down(w, i);
+    return drive(w, out_head);
+}
@@ -0,0 +1,44 @@
+/* lawn2w - low-watermark driven expiry on top of lawn2.
+ *
+ * Event-time pipelines fire timers when the low watermark (the minimum event
+ * time every input has promised not to go back behind) passes their
+ * deadline, not on wall ticks. lawn2w keeps one watermark per input and
+ * drives a lawn2 store's clock with their minimum:
+ *   - inputs sit in an indexed min-heap keyed by watermark, so an update is
+ *     O(log k) for k inputs and the combined watermark is the heap top
+ *   - an update that does not move the minimum (another input is behind,
+ *     or the input stalls) costs the sift alone and fires nothing
+ *   - one that does is a single lawn2_advance to the new minimum, however
+ *     far it jumped: O(non-empty blades), not O(elapsed ticks)
+ *   - an input can be marked idle so it stops holding the others back
+ * Push timers into the lawn2 store as usual (lawn2_add_at for event-time
+ * deadlines); its clock is the combined watermark.
+ */
+#ifndef LAWN2W_H
+#define LAWN2W_H
+
+#include "lawn2.h"
+
+typedef struct lawn2w lawn2w;
+
+/* Track ninputs inputs (ids 0..ninputs-1) over store l, which stays the
+ * caller's. Every input starts at lawn2_now(l). */
+lawn2w  *lawn2w_new(lawn2 *l, uint32_t ninputs);
+void     lawn2w_free(lawn2w *w);        /* frees the tracker, not the store */
+
+/* Input's watermark advanced to wm. Watermarks only move forward: a value
+ * not past the input's current one is ignored. If the combined watermark
+ * moved, advances the store to it and returns the number fired (their list
+ * in *out_head as for lawn2_advance); else returns 0. An idle input resumes
+ * here, at no less than the combined watermark. */
+uint64_t lawn2w_update(lawn2w *w, uint32_t input, uint64_t wm, lawn2_timer **out_head);
+/* Stop waiting on input until its next lawn2w_update. Returns the number
+ * fired if that lets the combined watermark move, as lawn2w_update. */
+uint64_t lawn2w_idle(lawn2w *w, uint32_t input, lawn2_timer **out_head);
+
+/* Minimum over the active inputs' watermarks; UINT64_MAX if all are idle
+ * (the store then stays where it is). */
+uint64_t lawn2w_watermark(lawn2w *w);
+uint64_t lawn2w_input(lawn2w *w, uint32_t input);  /* UINT64_MAX while idle */
+
+#endif /* LAWN2W_H */
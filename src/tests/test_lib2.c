@@ -21,6 +21,8 @@
 typedef struct test_state_store {
     lawn2       *l;
     timer_store *st;
+    lawn2       *ref;       /* differential tests: the store l must match */
+    timer_store *ref_st;
 } state;
 
 static state *init(void) {
@@ -30,12 +32,69 @@ static state *init(void) {
     return s;
 }
 
+/* l built from cfg, plus a reference store built from ref_cfg (a plain
+ * lawn2_new() if NULL) with a timer of its own for every id. */
+static state *init_pair(const lawn2_config *cfg, const lawn2_config *ref_cfg) {
+    state *s = calloc(1, sizeof *s);
+    s->l = lawn2_new_config(cfg);
+    s->st = init_store();
+    s->ref = ref_cfg ? lawn2_new_config(ref_cfg) : lawn2_new();
+    s->ref_st = init_store();
+    return s;
+}
+
 static void destroy(state *s) {
     lawn2_free(s->l);
     destroy_store(s->st);
+    if (s->ref) {
+        lawn2_free(s->ref);
+        destroy_store(s->ref_st);
+    }
     free(s);
 }
 
+static lawn2_timer *ref_timer(state *s, uint64_t id) { return timer_for(s->ref_st, id); }
+
+/* The same operation on id in both stores. */
+static void pair_add(state *s, uint64_t id, uint64_t ttl) {
+    lawn2_add(s->l, timer_for(s->st, id), ttl);
+    lawn2_add(s->ref, ref_timer(s, id), ttl);
+}
+
+static void pair_del(state *s, uint64_t id) {
+    lawn2_del(s->l, timer_for(s->st, id));
+    lawn2_del(s->ref, ref_timer(s, id));
+}
+
+static void pair_extend(state *s, uint64_t id, uint64_t delay) {
+    lawn2_extend(s->l, timer_for(s->st, id), delay);
+    lawn2_extend(s->ref, ref_timer(s, id), delay);
+}
+
+static void pair_advance(state *s, uint64_t target_now) {
+    lawn2_advance(s->l, target_now, NULL);
+    lawn2_advance(s->ref, target_now, NULL);
+}
+
+/* What a touch or extend of id in l must match: an eager del + add, and
+ * nothing once it has fired. */
+static void ref_requeue(state *s, uint64_t id, uint64_t ttl) {
+    if (!ref_timer(s, id)->in_store) return;
+    lawn2_del(s->ref, ref_timer(s, id));
+    lawn2_add(s->ref, ref_timer(s, id), ttl);
+}
+
+/* One lawn2_tick of both stores: FAIL unless they fire as many timers and,
+ * with same_order, the same ids in the same order. */
+static int pair_tick(state *s, int same_order) {
+    lawn2_timer *a, *b;
+    uint64_t got = lawn2_tick(s->l, &a), want = lawn2_tick(s->ref, &b);
+    if (got != want) return FAIL;
+    if (same_order)
+        for (; a && b; a = a->next, b = b->next) if (a->id != b->id) return FAIL;
+    return SUCCESS;
+}
+
 #if defined(__GNUC__) || defined(__clang__)
 __attribute__((format(printf, 2, 3)))
 #endif
@@ -260,6 +319,1280 @@ int test_pop_expired() {
 }
 
 
+/* Earliest expiration over every node still in the store (brute force). */
+static uint64_t min_live_expiration(timer_store *st, uint64_t n) {
+  uint64_t m = UINT64_MAX;
+  for (uint64_t i = 0; i < n; i++) {
+    lawn2_timer *t = timer_for(st, i);
+    if (t->in_store && t->expiration < m) m = t->expiration;
+  }
+  return m;
+}
+
+
+int test_indexed_mode() {
+  const uint64_t n = 2000;
+  lawn2_config cfg = { .flags = LAWN2_INDEXED };
+  state* s = init();
+  lawn2 *idx = lawn2_new_config(&cfg);
+  timer_store *ist = init_store();
+  int retval = SUCCESS;
+
+  /* ~500 distinct ttls: enough to force several grows */
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t ttl = 1 + (i * 7919) % 500;
+    lawn2_add(s->l, timer_for(s->st, i), ttl);
+    lawn2_add(idx, timer_for(ist, i), ttl);
+  }
+  /* deleting heads must keep next_expiration exact, not a lower bound */
+  for (uint64_t i = 0; i < n; i += 3) {
+    lawn2_del(s->l, timer_for(s->st, i));
+    lawn2_del(idx, timer_for(ist, i));
+  }
+  for (uint64_t t = 0; t < 520 && retval == SUCCESS; t++) {
+    uint64_t exact = min_live_expiration(ist, n);
+    if (lawn2_next_expiration(idx) != exact) {
+      printf("ERROR: tick %llu next_expiration %llu, exact %llu\n",
+             t, lawn2_next_expiration(idx), exact);
+      retval = FAIL;
+    }
+    uint64_t want = lawn2_tick(s->l, NULL);
+    uint64_t got = lawn2_tick(idx, NULL);
+    if (got != want) {
+      printf("ERROR: tick %llu indexed fired %llu, plain fired %llu\n", t, got, want);
+      retval = FAIL;
+    }
+  }
+  if (retval == SUCCESS && (lawn2_size(idx) != 0 || lawn2_next_expiration(idx) != UINT64_MAX)) {
+    printf("ERROR: indexed store not drained: size %llu\n", lawn2_size(idx));
+    retval = FAIL;
+  }
+
+  lawn2_free(idx);
+  destroy_store(ist);
+  destroy(s);
+  return retval;
+}
+
+
+int test_scan_kernels() {
+  const uint64_t n = 3000;
+  lawn2_config cfg = { .flags = LAWN2_NO_SIMD };
+  state* s = init();
+  lawn2 *scalar = lawn2_new_config(&cfg);
+  timer_store *sst = init_store();
+  int retval = SUCCESS;
+
+  /* 37 distinct ttls: a live count that is not a multiple of the vector width */
+  for (uint64_t i = 0; i < n; i++) {
+    uint64_t ttl = 5 + (i * 31) % 37 * 11;
+    if (i % 100 == 0) {  /* staggered arrivals so heads differ per blade */
+      lawn2_advance(s->l, lawn2_now(s->l) + 1, NULL);
+      lawn2_advance(scalar, lawn2_now(scalar) + 1, NULL);
+    }
+    lawn2_add(s->l, timer_for(s->st, i), ttl);
+    lawn2_add(scalar, timer_for(sst, i), ttl);
+  }
+  for (uint64_t t = 0; t < 450 && retval == SUCCESS; t++) {
+    uint64_t want = lawn2_tick(scalar, NULL);
+    uint64_t got = lawn2_tick(s->l, NULL);
+    uint64_t exact = min_live_expiration(s->st, n);
+    if (got != want || lawn2_next_expiration(s->l) != exact
+        || lawn2_next_expiration(scalar) != exact) {
+      printf("ERROR: tick %llu fired %llu/%llu next %llu/%llu exact %llu\n", t, got, want,
+             lawn2_next_expiration(s->l), lawn2_next_expiration(scalar), exact);
+      retval = FAIL;
+    }
+  }
+  if (retval == SUCCESS && lawn2_size(s->l) != 0) {
+    printf("ERROR: store not drained: size %llu\n", lawn2_size(s->l));
+    retval = FAIL;
+  }
+
+  lawn2_free(scalar);
+  destroy_store(sst);
+  destroy(s);
+  return retval;
+}
+
+
+/* lawn2_del goes through the node's cached blade index, so that index has to
+ * survive every grow of the TTL table between the add and the del. */
+int test_del_after_grow() {
+  state* s = init();
+  lawn2_timer *first = timer_for(s->st, 0);
+  lawn2_add(s->l, first, 5);
+  uint32_t blade = first->blade;
+  for (uint64_t i = 1; i <= 1000; i++)   /* 1000 new ttls: many grows */
+    lawn2_add(s->l, timer_for(s->st, i), 5 + i);
+  if (first->blade != blade)
+    return fail_with_error(s, "ERROR: blade index moved from %u to %u\n", blade, first->blade);
+  lawn2_del(s->l, first);
+  lawn2_del(s->l, timer_for(s->st, 1));
+  if (lawn2_size(s->l) != 999)
+    return fail_with_error(s, "ERROR: expected 999 timers, found %llu\n", lawn2_size(s->l));
+  if (lawn2_advance(s->l, 6, NULL) != 0)
+    return fail_with_error(s, "ERROR: deleted timer fired\n");
+  if (lawn2_advance(s->l, 7, NULL) != 1)
+    return fail_with_error(s, "ERROR: ttl 7 timer did not fire after its neighbour was deleted\n");
+  destroy(s);
+  return SUCCESS;
+}
+
+
+/* Churn over thousands of distinct TTLs with only a few live at a time
+ * (cancelled shortly after arming, plus the odd one that fires): with
+ * idle_ticks the table tracks the live TTLs instead of every TTL ever seen,
+ * in both modes, and the schedule matches a store that never reclaims. */
+int test_idle_reclaim() {
+  const uint64_t rounds = 5000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0, .idle_ticks = 8 };
+    state *s = init_pair(&cfg, NULL);
+    lawn2_stats stats;
+    for (uint64_t i = 0; i < rounds && retval == SUCCESS; i++) {
+      pair_add(s, i, (i % 10 == 0) ? 3 : 100 + (i * 7919) % 4000);
+      if (i >= 4) pair_del(s, i - 4);
+      if (pair_tick(s, 0) == FAIL) {
+        printf("ERROR: mode %d tick %llu fired differently from the reference\n", mode, i);
+        retval = FAIL;
+      }
+    }
+    lawn2_get_stats(s->l, &stats);
+    if (stats.reclaimed == 0 || stats.blades > 64 || stats.table_cap > 256) {
+      printf("ERROR: mode %d holds %llu blades in %llu slots after %llu reclaims\n",
+             mode, stats.blades, stats.table_cap, stats.reclaimed);
+      retval = FAIL;
+    }
+    /* once everything drains and idles out, the table shrinks back down */
+    lawn2_advance(s->l, lawn2_now(s->l) + 100000, NULL);
+    lawn2_advance(s->l, lawn2_now(s->l) + 100, NULL);
+    lawn2_get_stats(s->l, &stats);
+    if (lawn2_size(s->l) != 0 || stats.blades != 0 || stats.table_cap != 16) {
+      printf("ERROR: mode %d left %llu blades in %llu slots\n", mode, stats.blades, stats.table_cap);
+      retval = FAIL;
+    }
+    /* a reclaimed TTL comes back as a fresh blade */
+    lawn2_add(s->l, timer_for(s->st, 0), 50);
+    if (lawn2_advance(s->l, lawn2_now(s->l) + 50, NULL) != 1) {
+      printf("ERROR: mode %d re-added TTL did not fire\n", mode);
+      retval = FAIL;
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* New TTLs arriving while the table resizes incrementally: every TTL keeps
+ * exactly one blade whether it is still in the old table or already moved,
+ * and lawn2_reserve pre-sizes so the table never resizes at all (and
+ * ignores requests past LAWN2_RESERVE_MAX instead of hanging on them). */
+int test_incremental_resize() {
+  const uint64_t n = 3000;
+  int retval = SUCCESS;
+  for (int reserve = 0; reserve < 2 && retval == SUCCESS; reserve++) {
+    lawn2 *l = lawn2_new();
+    timer_store *st = init_store();
+    lawn2_stats stats;
+    if (reserve) {
+      reserve_store(st, 2 * n);
+      lawn2_reserve(l, n);
+    }
+    lawn2_get_stats(l, &stats);
+    uint64_t cap0 = stats.table_cap;
+    lawn2_reserve(l, UINT64_MAX);               /* past LAWN2_RESERVE_MAX: a no-op */
+    lawn2_reserve(l, LAWN2_RESERVE_MAX + 1);
+    lawn2_get_stats(l, &stats);
+    if (stats.table_cap != cap0) retval = FAIL;
+    for (uint64_t i = 0; i < n; i++) {
+      lawn2_add(l, timer_for(st, 2 * i), 10 + i);
+      lawn2_add(l, timer_for(st, 2 * i + 1), 10 + i / 2);   /* an older TTL */
+    }
+    lawn2_get_stats(l, &stats);
+    if (stats.blades != n || (reserve && stats.table_cap != cap0)) {
+      printf("ERROR: reserve %d: %llu blades for %llu ttls, table %llu -> %llu slots\n",
+             reserve, stats.blades, n, cap0, stats.table_cap);
+      retval = FAIL;
+    }
+    for (uint64_t t = 1; t < n + 20 && retval == SUCCESS; t++) {
+      uint64_t want = (t >= 10 && t - 10 < n) + 2 * (t >= 10 && t - 10 < n / 2);
+      uint64_t got = lawn2_tick(l, NULL);
+      if (got != want) {
+        printf("ERROR: reserve %d: tick %llu fired %llu, expected %llu\n", reserve, t, got, want);
+        retval = FAIL;
+      }
+    }
+    lawn2_free(l);
+    destroy_store(st);
+  }
+  return retval;
+}
+
+
+/* A hot TTL plus many small blades, drained K at a time with deletes in
+ * between: nothing fires twice or early, nothing due is left behind, each
+ * TTL fires in id (= expiry) order, and the totals match an unbudgeted
+ * store. Both modes. */
+int test_budgeted_poll() {
+  const uint64_t hot = 10000, cold = 2000, k = 97;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, NULL);
+    uint64_t *last_id = calloc(64, sizeof *last_id);
+    for (uint64_t i = 0; i < hot + cold; i++)
+      pair_add(s, i, i < hot ? 5 : 5 + i % 50);   /* cold ids spread over 50 ttls */
+    for (uint64_t t = 1; t <= 60 && retval == SUCCESS; t++) {
+      uint64_t want = lawn2_advance(s->ref, t, NULL), got = 0, calls = 0;
+      lawn2_timer *head;
+      uint64_t target = t;
+      do {
+        uint64_t n = lawn2_advance_budget(s->l, target, k, &head);
+        if (n > k) retval = FAIL;
+        target = lawn2_now(s->l);
+        /* the output list is LIFO: walk it backwards to get fire order */
+        lawn2_timer **v = malloc((n + 1) * sizeof *v);
+        uint64_t cnt = 0;
+        for (lawn2_timer *x = head; x; x = x->next) {
+          if (x->expiration > t || x->in_store) retval = FAIL;
+          v[cnt++] = x;
+        }
+        while (cnt--) {
+          lawn2_timer *x = v[cnt];
+          if (x->id && x->id <= last_id[x->ttl]) retval = FAIL;
+          last_id[x->ttl] = x->id;
+        }
+        free(v);
+        got += n;
+        calls++;
+        /* delete a due hot timer and drain a whole cold blade mid-drain */
+        if (lawn2_pending(s->l) && calls == 2) {
+          uint64_t cold_id = hot + (t + 7) % 50;
+          for (uint64_t id = cold_id; id < hot + cold + 50; id += 50) {
+            uint64_t victim = id < hot + cold ? id : hot - 1;
+            lawn2_timer *x = timer_for(s->st, victim);
+            if (!x->in_store) continue;
+            if (x->expiration <= t) want--;   /* ref already fired it */
+            pair_del(s, victim);
+          }
+        }
+      } while (lawn2_pending(s->l));
+      if (retval == FAIL || got != want) {
+        printf("ERROR: mode %d tick %llu fired %llu in %llu calls, expected %llu\n",
+               mode, t, got, calls, want);
+        retval = FAIL;
+      }
+    }
+    if (lawn2_size(s->l) != 0) {
+      printf("ERROR: mode %d left %llu timers\n", mode, lawn2_size(s->l));
+      retval = FAIL;
+    }
+    free(last_id);
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Segment output: the same timers fire on the same ticks as the list Poll,
+ * each segment is one TTL's due prefix in expiry order with the right count,
+ * popping clears in_store, and max_segs overflow resumes via pending. */
+int test_segments() {
+  const uint64_t n = 6000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, NULL);
+    for (uint64_t i = 0; i < n; i++) {
+      if (i % 500 == 0) pair_advance(s, lawn2_now(s->l) + 1);
+      pair_add(s, i, 3 + (i * 7919) % 40);
+    }
+    for (int t = 0; t < 60 && retval == SUCCESS; t++) {
+      uint64_t target = lawn2_now(s->l) + 1, want = lawn2_advance(s->ref, target, NULL), got = 0;
+      lawn2_segment segs[4];
+      size_t nsegs;
+      do {
+        got += lawn2_advance_segments(s->l, target, segs, 4, &nsegs);
+        for (size_t k = 0; k < nsegs; k++) {
+          uint64_t popped = 0, prev_exp = 0, count = segs[k].count;
+          lawn2_timer *x;
+          while ((x = lawn2_seg_pop(&segs[k]))) {
+            if (x->ttl != segs[k].ttl || x->expiration > target || x->expiration < prev_exp
+                || x->in_store || ref_timer(s, x->id)->in_store)
+              retval = FAIL;
+            prev_exp = x->expiration;
+            popped++;
+          }
+          if (popped != count) retval = FAIL;
+        }
+      } while (lawn2_pending(s->l));
+      if (retval == FAIL || got != want) {
+        printf("ERROR: mode %d tick %llu fired %llu, expected %llu\n", mode, target, got, want);
+        retval = FAIL;
+      }
+    }
+    if (lawn2_size(s->l) != 0) retval = FAIL;
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Ordered Poll over multi-tick jumps: every batch (and every budget-cut
+ * slice of one) runs in non-decreasing expiration order, slices never go
+ * back in time, and the totals match a plain lawn2_advance. Both modes. */
+int test_ordered_poll() {
+  const uint64_t n = 20000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, NULL);
+    for (uint64_t i = 0; i < n; i++) {
+      if (i % 100 == 0) pair_advance(s, lawn2_now(s->l) + 1);
+      pair_add(s, i, 1 + (i * 7919) % 500);
+    }
+    for (int round = 0; round < 40 && retval == SUCCESS; round++) {
+      uint64_t target = lawn2_now(s->l) + 1 + (round * 37) % 29;
+      uint64_t want = lawn2_advance(s->ref, target, NULL), got = 0, last = 0;
+      uint64_t budget = round % 2 ? 1000 : UINT64_MAX;
+      lawn2_timer *head;
+      do {
+        uint64_t fired = lawn2_advance_ordered(s->l, target, budget, &head), walked = 0;
+        for (lawn2_timer *x = head; x; x = x->next, walked++) {
+          if (x->expiration < last || x->expiration > target || x->in_store) retval = FAIL;
+          last = x->expiration;
+        }
+        if (walked != fired) retval = FAIL;
+        got += fired;
+      } while (lawn2_pending(s->l));
+      if (retval == FAIL || got != want) {
+        printf("ERROR: mode %d jump to %llu fired %llu, expected %llu\n", mode, target, got, want);
+        retval = FAIL;
+      }
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Array Poll: a small buffer drains a big tick across several calls, every
+ * slot holds a distinct fired node, and the totals match lawn2_advance. */
+int test_array_poll() {
+  const uint64_t n = 10000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, NULL);
+    for (uint64_t i = 0; i < n; i++) pair_add(s, i, 1 + i % 13);
+    lawn2_timer *buf[64];
+    for (uint64_t t = 1; t <= 14 && retval == SUCCESS; t++) {
+      uint64_t want = lawn2_advance(s->ref, t, NULL), got = 0;
+      size_t k;
+      do {
+        uint64_t fired = lawn2_advance_into(s->l, t, buf, 64, &k);
+        if (fired != k || k > 64) retval = FAIL;
+        for (size_t j = 0; j < k; j++) {
+          if (buf[j]->in_store || buf[j]->expiration != t || buf[j]->next) retval = FAIL;
+          buf[j]->id += n;      /* mark: a node seen twice fails the range check */
+          if (buf[j]->id >= 2 * n) retval = FAIL;
+        }
+        got += fired;
+      } while (lawn2_pending(s->l));
+      if (retval == FAIL || got != want) {
+        printf("ERROR: mode %d tick %llu stored %llu, expected %llu\n", mode, t, got, want);
+        retval = FAIL;
+      }
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Periodic timers sharing blades with one-shots fire every interval through
+ * every Poll flavour, are reported via lawn2_rearmed() (not in a Poll's
+ * output or its return value) and stay in the store; lawn2_del stops them. */
+int test_periodic() {
+  int retval = SUCCESS;
+  for (int flavour = 0; flavour < 5 && retval == SUCCESS; flavour++) {
+    lawn2_config cfg = { .flags = flavour == 4 ? LAWN2_INDEXED : 0 };
+    lawn2 *l = lawn2_new_config(&cfg);
+    timer_store *st = init_store();
+    for (uint64_t i = 0; i < 30; i++)                    /* 10 per interval 3, 4, 5 */
+      lawn2_add_periodic(l, timer_for(st, i), 3 + i % 3);
+    uint64_t fires[30] = {0};
+    for (uint64_t t = 1; t <= 60 && retval == SUCCESS; t++) {
+      lawn2_add(l, timer_for(st, 100 + t), 4);          /* a one-shot per tick */
+      uint64_t got = 0, oneshot = 0;
+      lawn2_timer *head, *buf[8];
+      lawn2_segment segs[2];
+      size_t k;
+      do {
+        uint64_t before = oneshot, ret = got;
+        switch (flavour) {
+          case 0: case 4: got += lawn2_tick(l, &head); break;
+          case 1: got += lawn2_advance_ordered(l, t, UINT64_MAX, &head); break;
+          case 2:
+            got += lawn2_advance_segments(l, t, segs, 2, &k);
+            for (size_t j = 0; j < k; j++)
+              while (lawn2_seg_pop(&segs[j])) oneshot++;
+            head = NULL;
+            break;
+          default:
+            got += lawn2_advance_into(l, t, buf, 8, &k);
+            oneshot += k;
+            head = NULL;
+            break;
+        }
+        for (lawn2_timer *x = head; x; x = x->next) oneshot++;
+        if (got - ret != oneshot - before) retval = FAIL;   /* count == what was handed back */
+        lawn2_timer **re = lawn2_rearmed(l, &k);
+        for (size_t j = 0; j < k; j++) {
+          if (!re[j]->in_store || re[j]->expiration != t + re[j]->ttl) retval = FAIL;
+          fires[re[j]->id]++;
+        }
+      } while (lawn2_pending(l));
+      if (got != oneshot || oneshot != (t >= 4)) {
+        printf("ERROR: flavour %d tick %llu: %llu one-shots fired\n", flavour, t, oneshot);
+        retval = FAIL;
+      }
+      if (t == 30)
+        for (uint64_t i = 0; i < 30; i += 2) lawn2_del(l, timer_for(st, i));
+    }
+    for (uint64_t i = 0; i < 30 && retval == SUCCESS; i++) {
+      uint64_t iv = 3 + i % 3, want = i % 2 ? 60 / iv : 30 / iv;
+      if (fires[i] != want) {
+        printf("ERROR: flavour %d periodic %llu fired %llu times, expected %llu\n", flavour, i, fires[i], want);
+        retval = FAIL;
+      }
+    }
+    if (lawn2_size(l) != 15 + 3) retval = FAIL;   /* odd periodics + 3 pending one-shots */
+    lawn2_free(l);
+    destroy_store(st);
+  }
+  return retval;
+}
+
+
+/* lawn2_touch behaves exactly like lawn2_del + lawn2_add with the same ttl:
+ * heads, middles, tails and lone timers, interleaved with ticks. */
+int test_touch() {
+  const uint64_t n = 3000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, &cfg);
+    for (uint64_t i = 0; i < n; i++) pair_add(s, i, 20 + i % 17);
+    for (uint64_t t = 1; t <= 200 && retval == SUCCESS; t++) {
+      for (uint64_t j = 0; j < 40; j++) {
+        uint64_t id = (t * 131 + j * 7919) % n;
+        lawn2_timer *x = timer_for(s->st, id);
+        if (!x->in_store) continue;
+        lawn2_touch(s->l, x);
+        ref_requeue(s, id, x->ttl);
+        if (x->expiration != ref_timer(s, id)->expiration) retval = FAIL;
+      }
+      if (lawn2_next_expiration(s->l) > lawn2_next_expiration(s->ref)
+          || (mode && lawn2_next_expiration(s->l) != lawn2_next_expiration(s->ref))) retval = FAIL;
+      if (pair_tick(s, 1) == FAIL) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu differs from del+add\n", mode, t);
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* lawn2_extend postpones lazily, but every timer must still fire on exactly
+ * the tick an eager lawn2_del + lawn2_add would fire it, through list and
+ * segment Polls alike, with deletes and touches of stale timers mixed in. */
+int test_lazy_extend() {
+  const uint64_t n = 3000;
+  int retval = SUCCESS;
+  uint64_t *fired = malloc(n * sizeof *fired), *want_fired = malloc(n * sizeof *want_fired);
+  for (int mode = 0; mode < 3 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode == 1 ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, &cfg);
+    for (uint64_t i = 0; i < n; i++) {
+      fired[i] = want_fired[i] = 0;
+      pair_add(s, i, 20 + i % 17);
+    }
+    for (uint64_t t = 1; t <= 300 && retval == SUCCESS; t++) {
+      for (uint64_t j = 0; j < 40 && t <= 200; j++) {
+        uint64_t id = (t * 131 + j * 7919) % n;
+        lawn2_timer *x = timer_for(s->st, id), *y = ref_timer(s, id);
+        if (!y->in_store) continue;
+        if (j % 10 == 9) {                      /* cancel: stale or not */
+          pair_del(s, id);
+        } else if (j % 10 == 8) {               /* touch: back to its own ttl */
+          lawn2_touch(s->l, x);
+          ref_requeue(s, id, 20 + id % 17);
+        } else {                                /* mostly later, sometimes earlier */
+          uint64_t delay = 5 + (id * 13 + t) % 60;
+          lawn2_extend(s->l, x, delay);
+          ref_requeue(s, id, delay);
+        }
+        if (x->in_store != y->in_store || (x->in_store && x->expiration != y->expiration)) retval = FAIL;
+        if (x->in_store && x->ttl != 20 + id % 17) retval = FAIL;  /* re-queued or not */
+      }
+      if (lawn2_next_expiration(s->l) > lawn2_next_expiration(s->ref)
+          || (mode == 1 && lawn2_next_expiration(s->l) != lawn2_next_expiration(s->ref))) retval = FAIL;
+      uint64_t got = 0, want = 0;
+      lawn2_timer *a, *b;
+      if (mode == 2) {
+        lawn2_segment segs[4];
+        size_t nsegs;
+        do {
+          got += lawn2_advance_segments(s->l, t, segs, 4, &nsegs);
+          for (size_t i = 0; i < nsegs; i++)
+            while ((a = lawn2_seg_pop(&segs[i]))) fired[a->id] = t;
+        } while (lawn2_pending(s->l));
+      } else {
+        got = lawn2_tick(s->l, &a);
+        for (; a; a = a->next) fired[a->id] = t;
+      }
+      want = lawn2_tick(s->ref, &b);
+      for (; b; b = b->next) want_fired[b->id] = t;
+      if (got != want || lawn2_size(s->l) != lawn2_size(s->ref)) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu fired %llu, del+add fired %llu\n", mode, t, got, want);
+    }
+    for (uint64_t i = 0; i < n && retval == SUCCESS; i++)
+      if (fired[i] != want_fired[i]) {
+        printf("ERROR: mode %d id %llu fired on tick %llu, expected %llu\n", mode, i, fired[i], want_fired[i]);
+        retval = FAIL;
+      }
+    if (lawn2_size(s->l) != 0) retval = FAIL;
+    /* extend, then touch: refreshed by its own ttl whether the extension
+     * was eager (earlier) or re-queued it lazily (past its ttl) */
+    for (int lazy = 0; lazy < 2 && retval == SUCCESS; lazy++) {
+      lawn2_timer *x = timer_for(s->st, 0), *y = timer_for(s->st, 1);
+      lawn2_add(s->l, y, 30);
+      lawn2_add(s->l, x, 30);
+      lawn2_extend(s->l, x, lazy ? 100 : 5);
+      lawn2_del(s->l, y);                       /* x reaches the head */
+      lawn2_tick(s->l, NULL);
+      uint64_t ttl = x->ttl;
+      lawn2_touch(s->l, x);
+      if (ttl != 30 || x->ttl != 30 || lawn2_expiration(s->l, x) != lawn2_now(s->l) + 30) {
+        printf("ERROR: mode %d %s extend + touch: ttl %llu then %llu, deadline %llu at now %llu\n",
+               mode, lazy ? "lazy" : "eager", ttl, x->ttl, lawn2_expiration(s->l, x), lawn2_now(s->l));
+        retval = FAIL;
+      }
+      lawn2_del(s->l, x);
+    }
+    destroy(s);
+  }
+  free(fired);
+  free(want_fired);
+  return retval;
+}
+
+/* Extending every timer of a blade past its TTL: the lazy ones first, then
+ * the head, whose settle() defers the whole blade. The emptied blade must be
+ * retired and every timer still fire on its new deadline, in scan, indexed
+ * and hybrid mode, against eager del + add. */
+int test_extend_whole_blade() {
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 3 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode == 1 ? LAWN2_INDEXED : 0, .cold_max = mode == 2 ? 4 : 0 };
+    lawn2_config exact = { .flags = LAWN2_INDEXED };  /* l's next_expiration may not exceed it */
+    state *s = init_pair(&cfg, &exact);
+    /* two timers, tail first */
+    pair_add(s, 0, 10);
+    pair_add(s, 1, 10);
+    for (uint64_t id = 2; id > 0; id--) {
+      lawn2_extend(s->l, timer_for(s->st, id - 1), 100);
+      ref_requeue(s, id - 1, 100);
+    }
+    /* several blades of eight, spread over a few ticks, every node postponed
+     * past its TTL in an order that leaves runs of stale nodes behind the head */
+    for (uint64_t id = 2; id < 2 + 8 * 12; id++) {
+      if (id % 8 == 2) pair_advance(s, lawn2_now(s->l) + 1);
+      pair_add(s, id, 20 + id % 3);
+    }
+    for (uint64_t k = 0; k < 8 * 12; k++) {
+      uint64_t id = 2 + (k * 5 + 3) % (8 * 12);
+      lawn2_extend(s->l, timer_for(s->st, id), 40 + id % 7);
+      ref_requeue(s, id, 40 + id % 7);
+    }
+    for (uint64_t t = 0; t < 110 && retval == SUCCESS; t++) {
+      if (lawn2_next_expiration(s->l) > lawn2_next_expiration(s->ref)
+          || pair_tick(s, 0) == FAIL || lawn2_size(s->l) != lawn2_size(s->ref)) {
+        printf("ERROR: mode %d tick %llu differs from del+add\n", mode, lawn2_now(s->l));
+        retval = FAIL;
+      }
+    }
+    if (lawn2_size(s->l) != 0) retval = FAIL;
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Extends that leave stale heads already due at the next Poll must not let
+ * them jump the queue: over multi-tick jumps the ordered Poll stays in
+ * expiration order, and the array and budget Polls keep each blade's timers
+ * in expiration order, across budget cuts, in every mode. Blades are told
+ * apart by x->blade: a re-queued timer keeps its own ttl in another blade. */
+static uint64_t drain_ordered(state *s, uint64_t target, int how, int *ok) {
+  lawn2_timer *buf[16], *head;
+  uint64_t got = 0, last = 0, to = target, last_exp[128] = {0};
+  size_t k;
+  do {
+    if (how == 1) {
+      got += lawn2_advance_into(s->l, to, buf, 16, &k);
+    } else {
+      k = how ? lawn2_advance_budget(s->l, to, 16, &head) : lawn2_advance_ordered(s->l, to, 16, &head);
+      got += k;
+      for (size_t j = 0; head; head = head->next, j++)
+        buf[how ? k - 1 - j : j] = head;         /* the budget list is LIFO */
+    }
+    for (size_t j = 0; j < k; j++) {
+      lawn2_timer *x = buf[j];
+      if (x->in_store || ref_timer(s, x->id)->in_store || x->expiration > target) *ok = 0;
+      if (!how && x->expiration < last) *ok = 0;
+      if (x->blade >= 128 || x->expiration < last_exp[x->blade]) *ok = 0;
+      else last_exp[x->blade] = x->expiration;
+      last = x->expiration;
+    }
+    to = lawn2_now(s->l);
+  } while (lawn2_pending(s->l));
+  return got;
+}
+
+int test_extend_poll_order() {
+  const uint64_t n = 6000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 3 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode == 1 ? LAWN2_INDEXED : 0, .cold_max = mode == 2 ? 4 : 0 };
+    for (int how = 0; how < 3 && retval == SUCCESS; how++) {
+      state *s = init_pair(&cfg, NULL);
+      int ok = 1;
+      /* X, A, B due at 10, 11, 12; A postponed to 13 behind X */
+      for (uint64_t id = 0; id < 3; id++) {
+        pair_advance(s, id);
+        pair_add(s, id, 10);
+      }
+      lawn2_extend(s->l, timer_for(s->st, 1), 11);
+      ref_requeue(s, 1, 11);
+      uint64_t want = lawn2_advance(s->ref, 20, NULL), got = drain_ordered(s, 20, how, &ok);
+      uint64_t id = 3;
+      for (int jump = 0; jump < 300 && ok && got == want; jump++) {
+        for (int k = 0; k < 20 && id < n; k++, id++) pair_add(s, id, 10 + id % 23);
+        for (uint64_t k = 0; k < 30; k++) {
+          uint64_t v = (jump * 7919 + k * 131) % id, delay = 1 + (v + jump) % 70;  /* often past the TTL */
+          lawn2_extend(s->l, timer_for(s->st, v), delay);
+          ref_requeue(s, v, delay);
+        }
+        uint64_t target = lawn2_now(s->l) + 1 + jump % 9;
+        want = lawn2_advance(s->ref, target, NULL);
+        got = drain_ordered(s, target, how, &ok);
+      }
+      if (ok && got == want) {                  /* drain the rest */
+        want = lawn2_advance(s->ref, lawn2_now(s->l) + 100, NULL);
+        got = drain_ordered(s, lawn2_now(s->l) + 100, how, &ok);
+      }
+      if (!ok || got != want || lawn2_size(s->l) != 0) {
+        printf("ERROR: mode %d poll %d out of order at tick %llu\n", mode, how, lawn2_now(s->l));
+        retval = FAIL;
+      }
+      destroy(s);
+    }
+  }
+  return retval;
+}
+
+
+
+/* lawn2_add_batch must leave exactly the store n lawn2_add calls would:
+ * same blades, same order within each, so the same expiry stream. Batches
+ * mix runs, interleaved TTLs and more distinct TTLs than one group table. */
+int test_add_batch() {
+  const uint64_t n = 6000;
+  int retval = SUCCESS;
+  lawn2_timer *nodes[500];
+  uint64_t ttls[500];
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, &cfg);
+    for (uint64_t i = 0; i < n; ) {
+      size_t m = 1 + (i * 31) % 500;
+      if (m > n - i) m = n - i;
+      for (size_t k = 0; k < m; k++, i++) {
+        uint64_t ttl = (i / 1000) % 2 ? 5 + (i / 7) % 3 : 1 + (i * 7919) % 40;
+        nodes[k] = timer_for(s->st, i);
+        ttls[k] = ttl;
+        lawn2_add(s->ref, ref_timer(s, i), ttl);
+      }
+      lawn2_add_batch(s->l, nodes, ttls, m);
+      if (pair_tick(s, 1) == FAIL) retval = FAIL;
+    }
+    if (lawn2_size(s->l) != lawn2_size(s->ref) || lawn2_next_expiration(s->l) != lawn2_next_expiration(s->ref))
+      retval = FAIL;
+    for (int t = 0; t < 50 && retval == SUCCESS; t++) {
+      if (pair_tick(s, 1) == FAIL) {
+        printf("ERROR: mode %d tick %d batch fired differently from lawn2_add\n", mode, t);
+        retval = FAIL;
+      }
+    }
+    if (lawn2_size(s->l) != 0) retval = FAIL;
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* lawn2_del_batch against one lawn2_del per node: same survivors, same
+ * expiry stream, and next_expiration exact again afterwards in both modes.
+ * Batches hit heads, drain whole blades, repeat nodes, include absent and
+ * lazily extended ones, and overflow the dirty-blade list. */
+int test_del_batch() {
+  const uint64_t n = 8000;
+  int retval = SUCCESS;
+  lawn2_timer *batch[700];
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    state *s = init_pair(&cfg, &cfg);
+    for (uint64_t i = 0; i < n; i++) {
+      pair_add(s, i, 10 + i % 200);
+      if (i % 1000 == 999 && pair_tick(s, 1) == FAIL) retval = FAIL;
+    }
+    for (uint64_t i = 0; i < n; i += 5) pair_extend(s, i, 150);
+    for (uint64_t t = 1; t <= 250 && retval == SUCCESS; t++) {
+      size_t m = 0;
+      for (uint64_t j = 0; j < (t % 7) * 100; j++) {
+        uint64_t id = t % 3 ? (t * 977 + j * 7919) % n : (t + j * 200) % n;  /* random, or whole blades */
+        batch[m++] = timer_for(s->st, id);
+        if (j % 50 == 0) {                      /* listed twice */
+          batch[m] = batch[m - 1];
+          m++;
+        }
+      }
+      lawn2_del_batch(s->l, batch, m);
+      for (size_t k = 0; k < m; k++) lawn2_del(s->ref, ref_timer(s, batch[k]->id));
+      if (lawn2_size(s->l) != lawn2_size(s->ref)
+          || (mode && lawn2_next_expiration(s->l) != lawn2_next_expiration(s->ref))) retval = FAIL;
+      if (!mode && lawn2_next_expiration(s->l) < lawn2_next_expiration(s->ref)) retval = FAIL;
+      if (pair_tick(s, 1) == FAIL) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu differs from lawn2_del\n", mode, t);
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
+
+/* Whole-class detach and retime against a per-id model of deadlines: each
+ * tick must fire exactly the ids due by then, in both modes, through every
+ * retime path (fresh TTL, drained blade, merge into a live one, earlier). */
+int test_detach_retime() {
+  const uint64_t n = 6000;
+  int retval = SUCCESS;
+  uint64_t *deadline = calloc(n, sizeof *deadline), *cls = calloc(n, sizeof *cls);
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    lawn2 *l = lawn2_new_config(&cfg);
+    timer_store *st = init_store();
+    for (uint64_t i = 0; i < n; i++) {
+      uint64_t ttl = i < 100 ? 3 : 10 + i % 40;  /* class 3 drains early */
+      lawn2_add(l, timer_for(st, i), ttl);
+      deadline[i] = lawn2_now(l) + ttl;
+      cls[i] = ttl;
+      lawn2_timer *head = NULL;
+      if (i % 1000 == 999) lawn2_tick(l, &head);
+      for (; head; head = head->next) deadline[head->id] = 0;
+    }
+    for (uint64_t t = lawn2_now(l) + 1; t <= 400 && retval == SUCCESS; t++) {
+      uint64_t from = 10 + t % 40, to = 0;
+      if (t == 9) to = 3;                        /* onto a drained blade */
+      else if (t % 11 == 0) to = 10 + (t * 7) % 45;
+      else if (t % 13 == 0) to = 2;             /* earlier: part is due now */
+      if (to) {
+        uint64_t want = 0;
+        for (uint64_t i = 0; i < n; i++) {
+          if (!deadline[i] || cls[i] != from || from == to) continue;
+          deadline[i] = deadline[i] + to - from;  /* may be < t: fires at this tick */
+          cls[i] = to;
+          want++;
+        }
+        if (lawn2_retime_ttl(l, from, to) != want) retval = FAIL;
+      }
+      if (t % 17 == 0) {
+        lawn2_segment sg;
+        uint64_t got = lawn2_detach_ttl(l, 10 + t % 23, &sg), popped = 0;
+        for (lawn2_timer *x; (x = lawn2_seg_pop(&sg)); popped++) {
+          if (!deadline[x->id] || cls[x->id] != 10 + t % 23 || x->in_store) retval = FAIL;
+          deadline[x->id] = 0;
+        }
+        if (got != popped) retval = FAIL;
+      }
+      for (uint64_t i = 0; i < n; i += 97)
+        if (deadline[i] && lawn2_expiration(l, timer_for(st, i)) != deadline[i]) retval = FAIL;
+      lawn2_timer *head;
+      uint64_t got = lawn2_tick(l, &head), fired = 0;
+      for (; head; head = head->next, fired++) {
+        if (!deadline[head->id] || deadline[head->id] > t || head->in_store
+            || head->expiration != deadline[head->id] || head->ttl != cls[head->id]) retval = FAIL;
+        deadline[head->id] = 0;
+      }
+      for (uint64_t i = 0; i < n; i++) if (deadline[i] && deadline[i] <= t) retval = FAIL;
+      if (got != fired) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu fired %llu\n", mode, t, got);
+    }
+    if (lawn2_size(l) != 0) retval = FAIL;
+    lawn2_free(l);
+    destroy_store(st);
+  }
+  free(deadline);
+  free(cls);
+  return retval;
+}
+
+
+/* Groups of timers spread over many blades: members leave their group as
+ * they fire (or are re-queued by lawn2_extend without leaving it), and
+ * lawn2_del_group cancels exactly the rest, periodic members included. */
+int test_groups() {
+  const int ngroups = 50, per = 12;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0 };
+    lawn2 *l = lawn2_new_config(&cfg);
+    lawn2_group *grp = calloc(ngroups, sizeof *grp);
+    lawn2_gtimer *g = calloc(ngroups * per, sizeof *g);
+    int *fired = calloc(ngroups * per, sizeof *fired);
+    for (int i = 0; i < ngroups * per; i++) {
+      g[i].t.id = i;
+      if (i % per == 0) {
+        lawn2_add_periodic(l, &g[i].t, 7);
+        lawn2_group_join(&grp[i / per], &g[i]);
+      } else {
+        lawn2_add_grouped(l, &g[i], 5 + (i * 37) % 60, &grp[i / per]);
+      }
+      if (i % 5 == 1) lawn2_extend(l, &g[i].t, 100);  /* deferred re-queue keeps it grouped */
+    }
+    for (int t = 0; t < 40; t++) {
+      lawn2_timer *head;
+      lawn2_tick(l, &head);
+      for (; head; head = head->next) {
+        if (head->flags & LAWN2_TIMER_GROUPED) retval = FAIL;
+        fired[head->id] = 1;
+      }
+    }
+    for (int k = 0; k < ngroups; k++) {
+      uint64_t want = 0;
+      for (int i = k * per; i < (k + 1) * per; i++) want += !fired[i];
+      if (grp[k].count != want) retval = FAIL;
+      if (k % 2 && lawn2_del_group(l, &grp[k]) != want) retval = FAIL;
+      if (k % 2 && (grp[k].head || grp[k].count)) retval = FAIL;
+    }
+    for (int t = 0; t < 200; t++) {
+      lawn2_timer *head;
+      lawn2_tick(l, &head);
+      for (; head; head = head->next)
+        if ((head->id / per) % 2) retval = FAIL;  /* cancelled group fired */
+    }
+    /* only the even groups' periodic members are left */
+    if (lawn2_size(l) != (uint64_t)ngroups / 2) retval = FAIL;
+    for (int k = 0; k < ngroups; k += 2)
+      if (grp[k].count != 1 || lawn2_del_group(l, &grp[k]) != 1) retval = FAIL;
+    if (lawn2_size(l) != 0) retval = FAIL;
+    if (retval == FAIL) printf("ERROR: mode %d group membership out of step\n", mode);
+    lawn2_free(l);
+    free(grp);
+    free(g);
+    free(fired);
+  }
+  return retval;
+}
+
+
+/* Out-of-order event-time pushes, some past the disorder bound, mixed with
+ * deletes and lazy extends: every timer fires on the first tick at or after
+ * its deadline, the clamped ones at now - disorder + ttl. */
+int test_add_at() {
+  const uint64_t n = 30000, disorder = 20;
+  int retval = SUCCESS;
+  uint64_t *deadline = calloc(n, sizeof *deadline);
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0, .disorder = disorder };
+    lawn2 *l = lawn2_new_config(&cfg);
+    timer_store *st = init_store();
+    uint64_t id = 0;
+    for (uint64_t t = 1; t <= 700 && retval == SUCCESS; t++) {  /* adds stop at 600 */
+      for (int k = 0; k < 50 && id < n; k++, id++) {
+        uint64_t now = lawn2_now(l), late = (id * 7919) % 30, ttl = 5 + (id % 4) * 15;
+        uint64_t arrival = late > now ? 0 : now - late;
+        lawn2_add_at(l, timer_for(st, id), ttl, arrival);
+        deadline[id] = (now - arrival > disorder ? now - disorder : arrival) + ttl;
+        if (id % 13 == 0) {
+          lawn2_extend(l, timer_for(st, id), 40);
+          if (now + 40 != deadline[id]) deadline[id] = now + 40;
+        }
+        if (id % 17 == 0 && id >= 500) {
+          lawn2_del(l, timer_for(st, id - 500));
+          deadline[id - 500] = 0;
+        }
+      }
+      lawn2_timer *head;
+      uint64_t got = lawn2_tick(l, &head), fired = 0;
+      for (; head; head = head->next, fired++) {
+        if (!deadline[head->id] || deadline[head->id] > t || head->expiration != deadline[head->id])
+          retval = FAIL;
+        deadline[head->id] = 0;
+      }
+      for (uint64_t i = 0; i < id; i++) if (deadline[i] && deadline[i] <= t) retval = FAIL;
+      if (got != fired) retval = FAIL;
+      if (mode && lawn2_size(l) && lawn2_next_expiration(l) <= t) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu out of order\n", mode, t);
+    }
+    if (lawn2_size(l) != 0) retval = FAIL;
+    lawn2_free(l);
+    destroy_store(st);
+  }
+  free(deadline);
+  return retval;
+}
+
+
+/* TTL quantization: each policy never rounds down, is idempotent and keeps
+ * its error bound; a store under RELATIVE 1% folds thousands of distinct
+ * TTLs onto far fewer blades, fires each timer at now + its rounded TTL
+ * (single and batched pushes alike) and accounts the error exactly. */
+int test_quantize() {
+  const uint64_t n = 20000, ppm = 10000, grain = 100;
+  int retval = SUCCESS;
+  uint64_t seed = 7;
+  for (int i = 0; i < 100000 && retval == SUCCESS; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t ttl = i < 64 ? (uint64_t)i : (seed >> (seed & 63)) | 1;
+    if (i == 64) ttl = UINT64_MAX;
+    uint64_t k = lawn2_quantize(LAWN2_QUANT_KERNEL, 0, ttl);
+    uint64_t r = lawn2_quantize(LAWN2_QUANT_RELATIVE, ppm, ttl);
+    uint64_t f = lawn2_quantize(LAWN2_QUANT_FIXED, grain, ttl);
+    if (k < ttl || r < ttl || f < ttl || lawn2_quantize(LAWN2_QUANT_NONE, 0, ttl) != ttl) retval = FAIL;
+    if (lawn2_quantize(LAWN2_QUANT_KERNEL, 0, k) != k ||
+        lawn2_quantize(LAWN2_QUANT_RELATIVE, ppm, r) != r ||
+        lawn2_quantize(LAWN2_QUANT_FIXED, grain, f) != f) retval = FAIL;
+    if (ttl < 64 && k != ttl) retval = FAIL;                     /* kernel level 0 is exact */
+    if ((double)(r - ttl) * 1e6 > (double)ppm * (double)ttl) retval = FAIL;
+    if (f != ttl && (f % grain || f - ttl >= grain)) retval = FAIL;  /* saturates at the top */
+    if (retval == FAIL) printf("ERROR: ttl %llu rounds to %llu/%llu/%llu\n", ttl, k, r, f);
+  }
+
+  uint64_t *q = calloc(n, sizeof *q), *ttls = calloc(n, sizeof *ttls);
+  lawn2_timer **nodes = calloc(n, sizeof *nodes);
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0,
+                         .quant = LAWN2_QUANT_RELATIVE, .quant_param = ppm };
+    state *s = init_pair(&cfg, NULL);           /* ref holds the exact TTLs */
+    uint64_t rounded = 0, err_sum = 0, err_max = 0;
+    for (uint64_t i = 0; i < n; i++) {
+      ttls[i] = 1 + (i * 7919) % 5000;
+      q[i] = lawn2_quantize(LAWN2_QUANT_RELATIVE, ppm, ttls[i]);
+      nodes[i] = timer_for(s->st, i);
+      if (q[i] != ttls[i]) rounded++;
+      err_sum += q[i] - ttls[i];
+      if (q[i] - ttls[i] > err_max) err_max = q[i] - ttls[i];
+      lawn2_add(s->ref, ref_timer(s, i), ttls[i]);
+    }
+    for (uint64_t i = 0; i < n / 2; i++) lawn2_add(s->l, nodes[i], ttls[i]);
+    lawn2_add_batch(s->l, nodes + n / 2, ttls + n / 2, n - n / 2);
+    lawn2_stats qs, e;
+    lawn2_get_stats(s->l, &qs);
+    lawn2_get_stats(s->ref, &e);
+    if (qs.blades * 4 > e.blades || qs.quant_rounded != rounded || qs.quant_err_sum != err_sum ||
+        qs.quant_err_max != err_max || qs.quant_ppm_max > ppm || e.quant_rounded) {
+      printf("ERROR: mode %d %llu blades vs %llu exact, %llu rounded\n", mode,
+             qs.blades, e.blades, qs.quant_rounded);
+      retval = FAIL;
+    }
+    for (uint64_t t = 1; t <= 5100 && retval == SUCCESS; t++) {
+      lawn2_timer *head;
+      lawn2_tick(s->l, &head);
+      for (; head; head = head->next)
+        if (q[head->id] != t) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu fired off its rounded TTL\n", mode, t);
+    }
+    if (lawn2_size(s->l) != 0) retval = FAIL;
+    destroy(s);
+  }
+  free(q);
+  free(ttls);
+  free(nodes);
+  return retval;
+}
+
+
+/* Slack pushes: every timer fires within [ttl, ttl + slack] of its push, on
+ * the tick its queued TTL says, while far fewer blades are held than exact
+ * TTLs would need. Idle reclamation and a retime between two waves check
+ * the TTL index follows blades coming and going; the lateness stats add up. */
+int test_slack() {
+  const uint64_t n = 20000, horizon = 3400;
+  int retval = SUCCESS;
+  uint64_t *due = calloc(n, sizeof *due), *expect = calloc(horizon + 1, sizeof *expect);
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0, .idle_ticks = 50 };
+    lawn2 *l = lawn2_new_config(&cfg);
+    timer_store *st = init_store();
+    memset(expect, 0, (horizon + 1) * sizeof *expect);
+    uint64_t id = 0, coalesced = 0, late_sum = 0, late_max = 0, slack_adds = 0, max_blades = 0;
+    for (uint64_t t = 1; t <= horizon && retval == SUCCESS; t++) {
+      /* two waves of pushes, the second after the first wave's blades were reclaimed */
+      int wave = (t <= 400) || (t > 1200 && t <= 1400);
+      for (int k = 0; wave && k < 25 && id < n; k++, id++) {
+        uint64_t ttl = 100 + (id * 7919) % 400, slack = id % 50 ? ttl / 10 : 0;
+        lawn2_timer *tm = timer_for(st, id);
+        lawn2_add_slack(l, tm, ttl, slack);
+        uint64_t late = tm->ttl - ttl;
+        if (tm->ttl < ttl || late > slack) retval = FAIL;
+        if (slack) slack_adds++;
+        if (late) coalesced++;
+        late_sum += late;
+        if (late > late_max) late_max = late;
+        due[id] = lawn2_now(l) + tm->ttl;
+        expect[due[id]]++;
+      }
+      if (t == 1300) {
+        /* move the exact 1000 class to 2000: the index must follow the blade */
+        lawn2_timer *a = timer_for(st, n - 1), *b = timer_for(st, n - 2), *c = timer_for(st, n - 3);
+        lawn2_add(l, a, 1000);
+        if (lawn2_retime_ttl(l, 1000, 2000) != 1) retval = FAIL;
+        due[n - 1] = lawn2_now(l) + 2000;
+        lawn2_add_slack(l, b, 1990, 20);
+        lawn2_add_slack(l, c, 995, 10);
+        if (b->ttl != 2000 || c->ttl != 995) retval = FAIL;
+        due[n - 2] = lawn2_now(l) + 2000;
+        due[n - 3] = lawn2_now(l) + 995;
+        expect[due[n - 1]] += 2;
+        expect[due[n - 3]]++;
+        coalesced++;
+        late_sum += 10;
+        if (late_max < 10) late_max = 10;
+        slack_adds += 2;
+      }
+      lawn2_stats s;
+      lawn2_get_stats(l, &s);
+      if (s.blades > max_blades) max_blades = s.blades;
+      lawn2_timer *head;
+      uint64_t got = lawn2_tick(l, &head);
+      for (; head; head = head->next)
+        if (due[head->id] != t) retval = FAIL;
+      if (got != expect[t]) retval = FAIL;
+      if (retval == FAIL) printf("ERROR: mode %d tick %llu fired off its slack window\n", mode, t);
+    }
+    lawn2_stats s;
+    lawn2_get_stats(l, &s);
+    if (lawn2_size(l) != 0 || s.reclaimed == 0 || max_blades > 120 || s.slack_adds != slack_adds ||
+        s.slack_coalesced != coalesced || s.slack_late_sum != late_sum || s.slack_late_max != late_max) {
+      printf("ERROR: mode %d held up to %llu blades, %llu left, slack stats %llu/%llu/%llu/%llu\n", mode, max_blades, lawn2_size(l),
+             s.slack_adds, s.slack_coalesced, s.slack_late_sum, s.slack_late_max);
+      retval = FAIL;
+    }
+    lawn2_free(l);
+    destroy_store(st);
+  }
+  free(due);
+  free(expect);
+  return retval;
+}
+
+
+/* Hybrid mode against a plain scan store, fed the same pushes, cancels,
+ * refreshes and lazy extends over a popular TTL set that shifts halfway
+ * through, under a long tail of near-unique TTLs. Polls alternate between
+ * plain, budgeted, ordered and segment flavours. Every timer must fire on
+ * the same tick in both, with blades promoted and demoted along the way. */
+static void hybrid_poll(lawn2 *l, uint64_t t, int how, uint64_t *fired_at) {
+  lawn2_timer *head;
+  lawn2_segment segs[3];
+  size_t nsegs;
+  uint64_t to = t;
+  do {
+    if (how == 0) {
+      lawn2_advance(l, to, &head);
+    } else if (how == 1) {
+      lawn2_advance_budget(l, to, 5, &head);
+    } else if (how == 2) {
+      lawn2_advance_ordered(l, to, 7, &head);
+    } else {
+      lawn2_advance_segments(l, to, segs, 3, &nsegs);
+      for (size_t k = 0; k < nsegs; k++)
+        for (lawn2_timer *x; (x = lawn2_seg_pop(&segs[k]));) fired_at[x->id] = t;
+      head = NULL;
+    }
+    for (; head; head = head->next) fired_at[head->id] = t;
+    to = lawn2_now(l);
+  } while (lawn2_pending(l));
+}
+
+int test_hybrid() {
+  const uint64_t n = 60000, ticks = 3000;
+  int retval = SUCCESS;
+  uint64_t *fa = calloc(n, sizeof *fa), *fb = calloc(n, sizeof *fb);
+  lawn2_config cfg = { .cold_max = 8 };
+  state *s = init_pair(&cfg, NULL);
+  uint64_t id = 0, seed = 99, max_cold = 0;
+  for (uint64_t t = 1; t <= ticks; t++) {
+    for (int k = 0; k < 20 && id < n; k++, id++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      uint64_t r = seed >> 33, ttl;
+      if (r % 4 == 0) ttl = 1 + (r >> 2) % 2000;                     /* long tail */
+      else ttl = (t < ticks / 3 ? 50 : 300) * (1 + (r >> 2) % 3);   /* popular, then shifted */
+      pair_add(s, id, ttl);
+      if (id >= 100 && r % 7 == 0) {
+        uint64_t v = id - 1 - (r >> 8) % 100;
+        switch ((r >> 4) % 3) {
+        case 0: pair_del(s, v); break;
+        case 1: lawn2_touch(s->l, timer_for(s->st, v)); lawn2_touch(s->ref, ref_timer(s, v)); break;
+        default: pair_extend(s, v, 10 + r % 400);
+        }
+      }
+    }
+    int how = t % 4 == 1 ? 0 : (int)(t % 4);
+    hybrid_poll(s->l, t, how, fa);
+    hybrid_poll(s->ref, t, 0, fb);
+    if (lawn2_size(s->l) != lawn2_size(s->ref) || lawn2_next_expiration(s->l) > lawn2_next_expiration(s->ref)) {
+      printf("ERROR: tick %llu: size %llu vs %llu\n", t, lawn2_size(s->l), lawn2_size(s->ref));
+      retval = FAIL;
+      break;
+    }
+    lawn2_stats hs;
+    lawn2_get_stats(s->l, &hs);
+    if (hs.cold_blades > max_cold) max_cold = hs.cold_blades;
+  }
+  for (uint64_t t = ticks + 1; lawn2_size(s->ref) && t < ticks + 3000; t++) {
+    hybrid_poll(s->l, t, 0, fa);
+    hybrid_poll(s->ref, t, 0, fb);
+  }
+  for (uint64_t i = 0; i < id; i++) {
+    if (fa[i] != fb[i]) {
+      printf("ERROR: timer %llu fired at %llu, scan store says %llu\n", i, fa[i], fb[i]);
+      retval = FAIL;
+      break;
+    }
+  }
+  lawn2_stats hs;
+  lawn2_get_stats(s->l, &hs);
+  if (lawn2_size(s->l) || lawn2_size(s->ref) || hs.promoted == 0 || hs.demoted == 0 || max_cold < 100) {
+    printf("ERROR: %llu left, promoted %llu, demoted %llu, up to %llu cold\n", lawn2_size(s->l),
+           hs.promoted, hs.demoted, max_cold);
+    retval = FAIL;
+  }
+  destroy(s);
+  free(fa);
+  free(fb);
+  return retval;
+}
+
+/* Hybrid mode: a cold blade that reaches cold_max timers through
+ * out-of-order inserts in front of its tail, or through a retime merging
+ * another class into it, is promoted just like one filled by tail pushes,
+ * and its timers still fire on their deadlines. */
+int test_hybrid_promote() {
+  int retval = SUCCESS;
+  lawn2_config cfg = { .cold_max = 8, .disorder = 20 };
+  lawn2 *l = lawn2_new_config(&cfg);
+  timer_store *st = init_store();
+  lawn2_stats s;
+  lawn2_advance(l, 100, NULL);
+  lawn2_add(l, timer_for(st, 0), 50);
+  for (uint64_t id = 1; id < 10; id++)           /* each lands ahead of the tail */
+    lawn2_add_at(l, timer_for(st, id), 50, 100 - id);
+  lawn2_get_stats(l, &s);
+  if (s.promoted != 1 || s.cold_blades != 0) {
+    printf("ERROR: %llu promoted, %llu still cold after out-of-order inserts\n", s.promoted, s.cold_blades);
+    retval = FAIL;
+  }
+  for (uint64_t t = 101; t <= 150 && retval == SUCCESS; t++) {
+    lawn2_timer *head;
+    uint64_t got = lawn2_tick(l, &head);
+    for (; head; head = head->next) if (head->expiration != t) retval = FAIL;
+    if (got != (t >= 141)) retval = FAIL;
+    if (retval == FAIL) printf("ERROR: tick %llu fired %llu\n", t, got);
+  }
+  /* two cold classes of five: merged, the target reaches cold_max */
+  for (uint64_t id = 0; id < 10; id++) lawn2_add(l, timer_for(st, id), id < 5 ? 30 : 40);
+  if (lawn2_retime_ttl(l, 30, 40) != 5) retval = FAIL;
+  lawn2_get_stats(l, &s);
+  if (s.promoted != 2 || s.cold_blades != 0) {
+    printf("ERROR: %llu promoted, %llu still cold after a retime merge\n", s.promoted, s.cold_blades);
+    retval = FAIL;
+  }
+  if (lawn2_advance(l, lawn2_now(l) + 39, NULL) != 0 || lawn2_advance(l, lawn2_now(l) + 1, NULL) != 10)
+    retval = FAIL;
+  if (lawn2_size(l) != 0) retval = FAIL;
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+/* cfg.direct_max is a lookup only: under churn that
+ * reclaims blades (their indices reused for other TTLs) and retimes a class
+ * back and forth across direct_max, a store with TTLs on both sides of it
+ * fires exactly like, and holds as many blades as, a plain hashed one. */
+int test_direct_blades() {
+  const uint64_t rounds = 5000;
+  int retval = SUCCESS;
+  for (int mode = 0; mode < 2 && retval == SUCCESS; mode++) {
+    lawn2_config cfg = { .flags = mode ? LAWN2_INDEXED : 0, .idle_ticks = 8, .direct_max = 2048 };
+    lawn2_config ref_cfg = { .flags = cfg.flags, .idle_ticks = 8 };
+    state *s = init_pair(&cfg, &ref_cfg);
+    lawn2 *l = s->l;
+    lawn2_stats stats, ref_stats;
+    uint64_t hot = 3;
+    for (uint64_t i = 0; i < rounds && retval == SUCCESS; i++) {
+      pair_add(s, i, (i % 3 == 0) ? hot : 100 + (i * 7919) % 4000);
+      if (i >= 4 && i % 5) pair_del(s, i - 4);
+      if (i % 250 == 249) {
+        uint64_t to = hot == 3 ? 5000 : 3;
+        if (lawn2_retime_ttl(l, hot, to) != lawn2_retime_ttl(s->ref, hot, to)) retval = FAIL;
+        hot = to;
+      }
+      if (pair_tick(s, 0) == FAIL) {
+        printf("ERROR: mode %d tick %llu fired differently from the reference\n", mode, i);
+        retval = FAIL;
+      }
+      lawn2_get_stats(l, &stats);
+      lawn2_get_stats(s->ref, &ref_stats);
+      if (stats.blades != ref_stats.blades || lawn2_size(l) != lawn2_size(s->ref)) {
+        printf("ERROR: mode %d tick %llu holds %llu blades, reference %llu\n",
+               mode, i, stats.blades, ref_stats.blades);
+        retval = FAIL;
+      }
+    }
+    if (lawn2_advance(l, lawn2_now(l) + 10000, NULL) != lawn2_advance(s->ref, lawn2_now(s->ref) + 10000, NULL))
+      retval = FAIL;
+    lawn2_advance(l, lawn2_now(l) + 100, NULL);
+    lawn2_get_stats(l, &stats);
+    if (lawn2_size(l) != 0 || stats.blades != 0) {
+      printf("ERROR: mode %d left %llu blades\n", mode, stats.blades);
+      retval = FAIL;
+    }
+    /* a reclaimed TTL's index goes to the next new one; the TTL coming back
+     * must get a blade of its own, direct or hashed */
+    for (uint64_t ttl = 1000; ttl < 8000; ttl += 3000) {   /* direct, then hashed */
+      lawn2_add(l, timer_for(s->st, 0), ttl);
+      lawn2_advance(l, lawn2_now(l) + ttl, NULL);
+      lawn2_advance(l, lawn2_now(l) + 100, NULL);   /* idle long enough: reclaimed */
+      lawn2_add(l, timer_for(s->st, 1), ttl + 1);
+      lawn2_add(l, timer_for(s->st, 2), ttl);
+      if (lawn2_advance(l, lawn2_now(l) + ttl, NULL) != 1) {
+        printf("ERROR: mode %d ttl %llu came back on another TTL's blade\n", mode, ttl);
+        retval = FAIL;
+      }
+      lawn2_advance(l, lawn2_now(l) + 100, NULL);
+    }
+    destroy(s);
+  }
+  return retval;
+}
+
 int main(int argc, char* argv[]) {
   mstime_t start_time = current_time_ms();
   int num_of_failed_tests = 0;
@@ -320,6 +1653,221 @@ int main(int argc, char* argv[]) {
     ++num_of_passed_tests;
   }
 
+  printf("-> del after grow\n");
+  if (test_del_after_grow() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on del after grow\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> idle reclaim\n");
+  if (test_idle_reclaim() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on idle reclaim\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> incremental resize\n");
+  if (test_incremental_resize() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on incremental resize\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> budgeted poll\n");
+  if (test_budgeted_poll() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on budgeted poll\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> segments\n");
+  if (test_segments() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on segments\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> ordered poll\n");
+  if (test_ordered_poll() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on ordered poll\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> array poll\n");
+  if (test_array_poll() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on array poll\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> periodic\n");
+  if (test_periodic() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on periodic\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> touch\n");
+  if (test_touch() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on touch\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> lazy extend\n");
+  if (test_lazy_extend() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on lazy extend\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> extend whole blade\n");
+  if (test_extend_whole_blade() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on extend whole blade\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> extend poll order\n");
+  if (test_extend_poll_order() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on extend poll order\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> add batch\n");
+  if (test_add_batch() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on add batch\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> del batch\n");
+  if (test_del_batch() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on del batch\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> detach/retime ttl\n");
+  if (test_detach_retime() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on detach/retime ttl\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> timer groups\n");
+  if (test_groups() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on timer groups\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> event-time add\n");
+  if (test_add_at() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on event-time add\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> ttl quantization\n");
+  if (test_quantize() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on ttl quantization\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> slack windows\n");
+  if (test_slack() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on slack windows\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> hybrid mode\n");
+  if (test_hybrid() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on hybrid mode\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> hybrid promote\n");
+  if (test_hybrid_promote() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on hybrid promote\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> direct blades\n");
+  if (test_direct_blades() == FAIL) {
+    ++num_of_failed_tests;
+    printf(" FAILED on direct blades\n");
+  } else {
+    printf(" PASSED\n");
+    ++num_of_passed_tests;
+  }
+  printf("-> indexed mode\n");
+  if (test_indexed_mode() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on indexed mode\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
+  printf("-> scan kernels\n");
+  if (test_scan_kernels() == FAIL) {
+    ++num_of_failed_tests;
+    printf("FAILED on scan kernels\n");
+  } else {
+    printf("PASSED\n");
+    ++num_of_passed_tests;
+  }
+
   double total_time_ms = current_time_ms() - start_time;
   printf("\n-------------\n");
   if (num_of_failed_tests) {
@@ -0,0 +1,198 @@
+/* Tests for lawn2c, the compact index-linked lawn2 variant. Schedules are
+ * checked against lawn2 itself, which the rest of the suite already covers.
+ */
+#include "../lawn2c.h"
+#include "../lawn2.h"
+
+#include "../utils/millisecond_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SUCCESS 0
+#define FAIL 1
+
+
+int test_node_size() {
+  if (sizeof(lawn2c_timer) != 16) {
+    printf("ERROR: compact node is %zu bytes, expected 16\n", sizeof(lawn2c_timer));
+    return FAIL;
+  }
+  return SUCCESS;
+}
+
+
+int test_add_del() {
+  int retval = SUCCESS;
+  lawn2c *l = lawn2c_new();
+  if (lawn2c_add(l, 7, 100) || lawn2c_add(l, 9, 100) || lawn2c_add(l, 70000, 5)) retval = FAIL;
+  if (lawn2c_size(l) != 3 || !lawn2c_in_store(l, 70000) || lawn2c_expiration(l, 9) != 100) {
+    printf("ERROR: unexpected state after add: size %llu\n", lawn2c_size(l));
+    retval = FAIL;
+  }
+  if (lawn2c_del(l, 7) != 1 || lawn2c_del(l, 7) != 0 || lawn2c_in_store(l, 7) || lawn2c_size(l) != 2) {
+    printf("ERROR: del did not remove exactly once\n");
+    retval = FAIL;
+  }
+  if (lawn2c_add(l, LAWN2C_NIL, 1) != -1 || lawn2c_add(l, 1, (uint64_t)1 << 32) != -1) {
+    printf("ERROR: out-of-range id/ttl accepted\n");
+    retval = FAIL;
+  }
+  uint32_t head;
+  if (lawn2c_advance(l, 5, &head) != 1 || head != 70000 || lawn2c_next(l, head) != LAWN2C_NIL) {
+    printf("ERROR: expected id 70000 alone on the output list\n");
+    retval = FAIL;
+  }
+  lawn2c_free(l);
+  return retval;
+}
+
+
+/* Same adds/deletes as a lawn2 store, same per-tick expiry counts. */
+int test_matches_lawn2() {
+  const uint32_t n = 20000;
+  int retval = SUCCESS;
+  lawn2c *c = lawn2c_new();
+  lawn2 *l = lawn2_new();
+  timer_store *st = init_store();
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t ttl = 1 + (i * 7919u) % 300;
+    if (i % 1000 == 0) {
+      lawn2c_advance(c, lawn2c_now(c) + 3, NULL);
+      lawn2_advance(l, lawn2_now(l) + 3, NULL);
+    }
+    lawn2c_add(c, i, ttl);
+    lawn2_add(l, timer_for(st, i), ttl);
+  }
+  for (uint32_t i = 0; i < n; i += 7) {
+    lawn2c_del(c, i);
+    lawn2_del(l, timer_for(st, i));
+  }
+  for (int t = 0; t < 400 && retval == SUCCESS; t++) {
+    uint32_t head;
+    uint64_t got = lawn2c_tick(c, &head), walked = 0;
+    uint64_t want = lawn2_tick(l, NULL);
+    for (uint32_t id = head; id != LAWN2C_NIL; id = lawn2c_next(c, id)) {
+      if (lawn2c_in_store(c, id) || timer_for(st, id)->in_store) retval = FAIL;
+      walked++;
+    }
+    if (got != want || walked != got) {
+      printf("ERROR: tick %d compact fired %llu (walked %llu), lawn2 fired %llu\n", t, got, walked, want);
+      retval = FAIL;
+    }
+  }
+  if (lawn2c_size(c) != 0) retval = FAIL;
+  lawn2c_free(c);
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+/* A blade that stays busy for longer than 2^32 ticks must rebase its 32-bit
+ * offsets and still report (and fire on) the exact 64-bit expiration. */
+int test_rebase() {
+  const uint64_t ttl = (uint64_t)1 << 31, step = (uint64_t)1 << 30;
+  int retval = SUCCESS;
+  lawn2c *l = lawn2c_new();
+  for (uint32_t i = 0; i < 12 && retval == SUCCESS; i++) {
+    if (lawn2c_add(l, i, ttl)) {
+      printf("ERROR: add %u rejected\n", i);
+      retval = FAIL;
+    }
+    if (lawn2c_expiration(l, i) != lawn2c_now(l) + ttl) {
+      printf("ERROR: id %u expiration %llu, expected %llu\n", i, lawn2c_expiration(l, i), lawn2c_now(l) + ttl);
+      retval = FAIL;
+    }
+    lawn2c_advance(l, lawn2c_now(l) + step, NULL);
+  }
+  /* every id fires exactly on its own tick */
+  for (uint32_t i = 0; i < 12 && retval == SUCCESS; i++) {
+    if (!lawn2c_in_store(l, i)) continue;
+    uint64_t at = lawn2c_expiration(l, i);
+    lawn2c_advance(l, at - 1, NULL);
+    if (!lawn2c_in_store(l, i) || lawn2c_tick(l, NULL) != 1 || lawn2c_in_store(l, i)) {
+      printf("ERROR: id %u did not fire on tick %llu\n", i, at);
+      retval = FAIL;
+    }
+  }
+  lawn2c_free(l);
+  return retval;
+}
+
+
+/* Adds after lawn2c_set_now moves the clock back are accepted, land on the
+ * new now + ttl and fire with the same counts as lawn2. */
+int test_set_now_back() {
+  int retval = SUCCESS;
+  lawn2c *c = lawn2c_new();
+  lawn2 *l = lawn2_new();
+  timer_store *st = init_store();
+  lawn2c_set_now(c, 1000);
+  lawn2_set_now(l, 1000);
+  lawn2c_add(c, 0, 100);
+  lawn2_add(l, timer_for(st, 0), 100);
+  lawn2c_set_now(c, 500);
+  lawn2_set_now(l, 500);
+  for (uint32_t i = 1; i < 4; i++) {
+    uint64_t ttl = i == 3 ? 50 : 100;
+    if (lawn2c_add(c, i, ttl) || lawn2c_expiration(c, i) != 500 + ttl) {
+      printf("ERROR: add of id %u after moving the clock back rejected or misplaced\n", i);
+      retval = FAIL;
+    }
+    lawn2_add(l, timer_for(st, i), ttl);
+  }
+  if (lawn2c_expiration(c, 0) != 1100) {
+    printf("ERROR: id 0 expiration moved to %llu\n", lawn2c_expiration(c, 0));
+    retval = FAIL;
+  }
+  for (int t = 0; t < 700 && retval == SUCCESS; t++) {
+    uint64_t got = lawn2c_tick(c, NULL), want = lawn2_tick(l, NULL);
+    if (got != want) {
+      printf("ERROR: tick %d compact fired %llu, lawn2 fired %llu\n", t, got, want);
+      retval = FAIL;
+    }
+  }
+  if (lawn2c_size(c) != 0) retval = FAIL;
+  lawn2c_free(c);
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+int main(int argc, char* argv[]) {
+  mstime_t start_time = current_time_ms();
+  int num_of_failed_tests = 0;
+  int num_of_passed_tests = 0;
+  printf("-------------------\n  STARTING TESTS\n-------------------\n\n");
+
+  struct { const char *name; int (*fn)(void); } tests[] = {
+    {"node size", test_node_size},
+    {"add-del", test_add_del},
+    {"matches lawn2", test_matches_lawn2},
+    {"rebase", test_rebase},
+    {"set_now back", test_set_now_back},
+  };
+  for (size_t i = 0; i < sizeof tests / sizeof tests[0]; i++) {
+    printf("-> %s\n", tests[i].name);
+    if (tests[i].fn() == FAIL) {
+      ++num_of_failed_tests;
+      printf(" FAILED on %s\n", tests[i].name);
+    } else {
+      printf(" PASSED\n");
+      ++num_of_passed_tests;
+    }
+  }
+
+  double total_time_ms = current_time_ms() - start_time;
+  printf("\n-------------\n");
+  if (num_of_failed_tests) {
+    printf("Failed (%d tests failed and %d passed in %.2f sec)\n", num_of_failed_tests,
+           num_of_passed_tests, total_time_ms / 1000);
+    return FAIL;
+  } else {
+    printf("OK (%d tests passed in %.2f sec)\n\n", num_of_passed_tests, total_time_ms / 1000);
+    return SUCCESS;
+  }
+}
@@ -0,0 +1,156 @@
+/* Tests for lawn2r, the ring-buffer-blade lawn2 variant. Schedules are
+ * checked against lawn2 itself, which the rest of the suite already covers.
+ */
+#include "../lawn2r.h"
+#include "../lawn2.h"
+
+#include "../utils/millisecond_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SUCCESS 0
+#define FAIL 1
+
+
+int test_add_del() {
+  int retval = SUCCESS;
+  lawn2r *l = lawn2r_new();
+  if (lawn2r_add(l, 7, 100) || lawn2r_add(l, 9, 100) || lawn2r_add(l, 70000, 5)) retval = FAIL;
+  if (lawn2r_size(l) != 3 || !lawn2r_in_store(l, 70000) || lawn2r_next_expiration(l) != 5) {
+    printf("ERROR: unexpected state after add: size %llu\n", lawn2r_size(l));
+    retval = FAIL;
+  }
+  if (lawn2r_del(l, 7) != 1 || lawn2r_del(l, 7) != 0 || lawn2r_in_store(l, 7) || lawn2r_size(l) != 2) {
+    printf("ERROR: del did not remove exactly once\n");
+    retval = FAIL;
+  }
+  if (lawn2r_add(l, LAWN2R_NIL, 1) != -1) {
+    printf("ERROR: reserved id accepted\n");
+    retval = FAIL;
+  }
+  const uint32_t *ids;
+  if (lawn2r_advance(l, 5, &ids) != 1 || ids[0] != 70000 || lawn2r_in_store(l, 70000)) {
+    printf("ERROR: expected id 70000 alone in the fired array\n");
+    retval = FAIL;
+  }
+  /* 7's tombstone sits ahead of 9 in the same ring: only 9 may fire */
+  if (lawn2r_advance(l, 100, &ids) != 1 || ids[0] != 9 || lawn2r_size(l) != 0) {
+    printf("ERROR: tombstone fired or live entry skipped\n");
+    retval = FAIL;
+  }
+  lawn2r_free(l);
+  return retval;
+}
+
+
+/* Same adds/deletes/re-adds as a lawn2 store, same per-tick expiry sets. */
+int test_matches_lawn2() {
+  const uint32_t n = 20000;
+  int retval = SUCCESS;
+  lawn2r *r = lawn2r_new();
+  lawn2 *l = lawn2_new();
+  timer_store *st = init_store();
+  uint64_t *seen = calloc(n, sizeof *seen);
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t ttl = 1 + (i * 7919u) % 300;
+    if (i % 1000 == 0) {
+      lawn2r_advance(r, lawn2r_now(r) + 3, NULL);
+      lawn2_advance(l, lawn2_now(l) + 3, NULL);
+    }
+    lawn2r_add(r, i, ttl);
+    lawn2_add(l, timer_for(st, i), ttl);
+  }
+  for (uint32_t i = 0; i < n; i += 7) {
+    lawn2r_del(r, i);
+    lawn2_del(l, timer_for(st, i));
+  }
+  for (uint32_t i = 3; i < n; i += 11) {      /* re-add moves it */
+    lawn2r_add(r, i, 50 + i % 13);
+    lawn2_del(l, timer_for(st, i));
+    lawn2_add(l, timer_for(st, i), 50 + i % 13);
+  }
+  for (uint64_t t = 1; t <= 400 && retval == SUCCESS; t++) {
+    const uint32_t *ids;
+    lawn2_timer *head;
+    uint64_t got = lawn2r_tick(r, &ids);
+    uint64_t want = lawn2_tick(l, &head);
+    for (uint64_t k = 0; k < got; k++) {
+      if (lawn2r_in_store(r, ids[k])) retval = FAIL;
+      seen[ids[k]] = t;
+    }
+    for (; head; head = head->next) if (seen[head->id] != t) retval = FAIL;
+    if (got != want || lawn2r_size(r) != lawn2_size(l)) {
+      printf("ERROR: tick %llu ring fired %llu, lawn2 fired %llu\n", t, got, want);
+      retval = FAIL;
+    }
+  }
+  if (lawn2r_size(r) != 0) retval = FAIL;
+  free(seen);
+  lawn2r_free(r);
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+/* Cancel-and-re-arm churn on one TTL never lets anything fire, so only
+ * compaction keeps the ring from filling with tombstones; it must keep
+ * the live entries in order while doing so. */
+int test_cancel_churn() {
+  const uint32_t n = 1000;
+  int retval = SUCCESS;
+  lawn2r *l = lawn2r_new();
+  for (uint32_t i = 0; i < n; i++) lawn2r_add(l, i, 1000);
+  for (uint32_t k = 0; k < 200000; k++) {
+    uint32_t id = (k * 7919u) % n;
+    if (lawn2r_del(l, id) != 1) retval = FAIL;
+    lawn2r_add(l, id, 1000);
+    if (k % 2000 == 0) lawn2r_tick(l, NULL);
+  }
+  if (lawn2r_size(l) != n) retval = FAIL;
+  /* everything is due by now + 1000, in one ordered pass */
+  uint64_t fired = 0;
+  for (int t = 0; t < 1000; t++) fired += lawn2r_tick(l, NULL);
+  if (fired != n || lawn2r_size(l) != 0 || lawn2r_next_expiration(l) != UINT64_MAX) {
+    printf("ERROR: churned ring fired %llu of %u\n", fired, n);
+    retval = FAIL;
+  }
+  lawn2r_free(l);
+  return retval;
+}
+
+
+int main(int argc, char* argv[]) {
+  mstime_t start_time = current_time_ms();
+  int num_of_failed_tests = 0;
+  int num_of_passed_tests = 0;
+  printf("-------------------\n  STARTING TESTS\n-------------------\n\n");
+
+  struct { const char *name; int (*fn)(void); } tests[] = {
+    {"add-del", test_add_del},
+    {"matches lawn2", test_matches_lawn2},
+    {"cancel churn", test_cancel_churn},
+  };
+  for (size_t i = 0; i < sizeof tests / sizeof tests[0]; i++) {
+    printf("-> %s\n", tests[i].name);
+    if (tests[i].fn() == FAIL) {
+      ++num_of_failed_tests;
+      printf(" FAILED on %s\n", tests[i].name);
+    } else {
+      printf(" PASSED\n");
+      ++num_of_passed_tests;
+    }
+  }
+
+  double total_time_ms = current_time_ms() - start_time;
+  printf("\n-------------\n");
+  if (num_of_failed_tests) {
+    printf("Failed (%d tests failed and %d passed in %.2f sec)\n", num_of_failed_tests,
+           num_of_passed_tests, total_time_ms / 1000);
+    return FAIL;
+  } else {
+    printf("OK (%d tests passed in %.2f sec)\n\n", num_of_passed_tests, total_time_ms / 1000);
+    return SUCCESS;
+  }
+}
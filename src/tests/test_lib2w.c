@@ -0,0 +1,130 @@
+/* Tests for lawn2w, watermark-driven expiry over a lawn2 store. The
+ * combined watermark is checked against a plain scan over the inputs. */
+#include "../lawn2w.h"
+
+#include "../utils/millisecond_time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SUCCESS 0
+#define FAIL 1
+
+
+/* Nothing fires until the slowest input passes a deadline; idling that
+ * input lets the others drive. */
+int test_slowest_input() {
+  int retval = SUCCESS;
+  lawn2 *l = lawn2_new();
+  lawn2w *w = lawn2w_new(l, 3);
+  timer_store *st = init_store();
+  lawn2_add(l, timer_for(st, 1), 10);
+  lawn2_add(l, timer_for(st, 2), 50);
+  lawn2_timer *head;
+  if (lawn2w_update(w, 0, 100, &head) || lawn2w_update(w, 1, 30, &head) || head) retval = FAIL;
+  if (lawn2w_watermark(w) != 0 || lawn2_now(l) != 0) retval = FAIL;
+  if (lawn2w_update(w, 2, 20, &head) != 1 || head->id != 1 || lawn2_now(l) != 20) {
+    printf("ERROR: combined watermark 20 should fire id 1 alone\n");
+    retval = FAIL;
+  }
+  if (lawn2w_update(w, 2, 15, &head) || lawn2w_input(w, 2) != 20) retval = FAIL;  /* backwards */
+  if (lawn2w_idle(w, 2, &head) || lawn2w_watermark(w) != 30) retval = FAIL;
+  if (lawn2w_idle(w, 1, &head) != 1 || head->id != 2 || lawn2_now(l) != 100) {
+    printf("ERROR: idling the stalled inputs should let input 0 drive\n");
+    retval = FAIL;
+  }
+  /* a resumed input cannot pull the clock back */
+  if (lawn2w_update(w, 1, 40, &head) || lawn2w_input(w, 1) != 100) retval = FAIL;
+  lawn2w_idle(w, 0, NULL);
+  lawn2w_idle(w, 1, NULL);
+  if (lawn2w_watermark(w) != UINT64_MAX || lawn2_now(l) != 100) retval = FAIL;
+  lawn2w_free(w);
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+/* Thousands of inputs jumping and stalling independently: after every
+ * update the store sits at the scanned minimum and has fired exactly the
+ * timers due by it. */
+int test_matches_scan() {
+  const uint32_t k = 2000, n = 20000;
+  int retval = SUCCESS;
+  lawn2 *l = lawn2_new();
+  lawn2w *w = lawn2w_new(l, k);
+  timer_store *st = init_store();
+  uint64_t *wm = calloc(k, sizeof *wm), *deadline = calloc(n, sizeof *deadline);
+  for (uint32_t i = 0; i < n; i++) {
+    deadline[i] = 1 + (i * 7919u) % 5000;
+    lawn2_add(l, timer_for(st, i), deadline[i]);
+  }
+  uint64_t fired = 0, seed = 42;
+  for (uint32_t step = 0; step < 200000 && retval == SUCCESS; step++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint32_t in = (seed >> 33) % k;
+    uint64_t jump = (seed >> 20) % 8 ? (seed >> 40) % 4 : (seed >> 40) % 400;  /* stall, creep or jump */
+    lawn2_timer *head;
+    uint64_t got;
+    if (step % 997 == 0) {
+      got = lawn2w_idle(w, in, &head);
+      wm[in] = UINT64_MAX;
+    } else {
+      uint64_t from = wm[in] == UINT64_MAX ? lawn2_now(l) : wm[in];
+      got = lawn2w_update(w, in, from + jump, &head);
+      if (jump || wm[in] == UINT64_MAX) wm[in] = from + jump;
+    }
+    uint64_t min = UINT64_MAX;
+    for (uint32_t i = 0; i < k; i++) if (wm[i] < min) min = wm[i];
+    if (lawn2w_watermark(w) != min || (min != UINT64_MAX && lawn2_now(l) != min)) retval = FAIL;
+    for (; head; head = head->next, got--) {
+      if (deadline[head->id] > lawn2_now(l)) retval = FAIL;
+      fired++;
+    }
+    if (got) retval = FAIL;
+    if (retval == FAIL) printf("ERROR: step %u watermark %llu, scan says %llu\n", step, lawn2w_watermark(w), min);
+  }
+  uint64_t due = 0;
+  for (uint32_t i = 0; i < n; i++) due += deadline[i] <= lawn2_now(l);
+  if (fired != due || lawn2_size(l) != n - due) retval = FAIL;
+  free(wm);
+  free(deadline);
+  lawn2w_free(w);
+  lawn2_free(l);
+  destroy_store(st);
+  return retval;
+}
+
+
+int main(int argc, char* argv[]) {
+  mstime_t start_time = current_time_ms();
+  int num_of_failed_tests = 0;
+  int num_of_passed_tests = 0;
+  printf("-------------------\n  STARTING TESTS\n-------------------\n\n");
+
+  struct { const char *name; int (*fn)(void); } tests[] = {
+    {"slowest input", test_slowest_input},
+    {"matches scan", test_matches_scan},
+  };
+  for (size_t i = 0; i < sizeof tests / sizeof tests[0]; i++) {
+    printf("-> %s\n", tests[i].name);
+    if (tests[i].fn() == FAIL) {
+      ++num_of_failed_tests;
+      printf(" FAILED on %s\n", tests[i].name);
+    } else {
+      printf(" PASSED\n");
+      ++num_of_passed_tests;
+    }
+  }
+
+  double total_time_ms = current_time_ms() - start_time;
+  printf("\n-------------\n");
+  if (num_of_failed_tests) {
+    printf("Failed (%d tests failed and %d passed in %.2f sec)\n", num_of_failed_tests,
+           num_of_passed_tests, total_time_ms / 1000);
+    return FAIL;
+  } else {
+    printf("OK (%d tests passed in %.2f sec)\n\n", num_of_passed_tests, total_time_ms / 1000);
+    return SUCCESS;
+  }
+}